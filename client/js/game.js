@@ -38,6 +38,7 @@ export function initGame({ state, ui, send, addMessage, lobby }) {
             ai_no_move: 'AI Failed to Move',
             draw_agreement: 'Draw by Agreement',
             stalemate: 'Stalemate',
+            fifty_move_rule: 'Fifty-Move Rule',
             opponent_disconnected: 'Opponent Disconnected',
             insufficient_material: 'Insufficient Material',
         };
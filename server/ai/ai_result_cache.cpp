@@ -0,0 +1,120 @@
+#include "ai_result_cache.h"
+
+#include <iostream>
+
+AIResultCache* AIResultCache::instance = nullptr;
+pthread_mutex_t AIResultCache::instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+AIResultCache::AIResultCache(size_t capacity) {
+    size_t per_shard = (capacity + SHARD_COUNT - 1) / SHARD_COUNT;
+    for (Shard& shard : shards) {
+        pthread_mutex_init(&shard.mutex, nullptr);
+        shard.slots.resize(per_shard);
+        shard.index.reserve(per_shard);
+        shard.hand = 0;
+        shard.hits = 0;
+        shard.misses = 0;
+        for (Slot& slot : shard.slots) {
+            slot.used = false;
+            slot.referenced = false;
+        }
+    }
+}
+
+AIResultCache::~AIResultCache() {
+    for (Shard& shard : shards) {
+        pthread_mutex_destroy(&shard.mutex);
+    }
+}
+
+AIResultCache* AIResultCache::get_instance() {
+    initialize();
+    return instance;
+}
+
+void AIResultCache::initialize(size_t capacity) {
+    pthread_mutex_lock(&instance_mutex);
+    if (instance == nullptr) {
+        if (capacity == 0) capacity = DEFAULT_CAPACITY;
+        instance = new AIResultCache(capacity);
+        std::cout << "[AIResultCache] Initialized with room for " << capacity << " AI moves" << std::endl;
+    }
+    pthread_mutex_unlock(&instance_mutex);
+}
+
+bool AIResultCache::lookup(const ChessGame& position, const std::string& difficulty, int depth, CachedAIMove& out) {
+    const uint64_t position_key = position.getHash();
+    Shard& shard = shard_for(position_key);
+    pthread_mutex_lock(&shard.mutex);
+    auto it = shard.index.find(Key{position_key, difficulty, depth});
+    bool found = (it != shard.index.end());
+    CachedAIMove value;
+    if (found) {
+        value = shard.slots[it->second].value;
+        // Resolved against this position: equal keys do not prove equal positions
+        value.move = position.resolveMove(value.move);
+        found = !value.move.isNull();
+    }
+    if (found) {
+        shard.slots[it->second].referenced = true;
+        out = value;
+        shard.hits++;
+    } else {
+        shard.misses++;
+    }
+    pthread_mutex_unlock(&shard.mutex);
+    return found;
+}
+
+bool AIResultCache::store(uint64_t position_key, const std::string& difficulty, int depth, const ChessAIMoveResult& result) {
+    if (result.move.isNull() || result.from_book || result.stopped || result.depth_reached == 0) {
+        return false;
+    }
+    const CachedAIMove value{result.move, result.score, result.depth_reached};
+
+    Shard& shard = shard_for(position_key);
+    Key key{position_key, difficulty, depth};
+
+    pthread_mutex_lock(&shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        // Another game searched the same position meanwhile; keep the newer result
+        shard.slots[it->second].value = value;
+        pthread_mutex_unlock(&shard.mutex);
+        return true;
+    }
+
+    // Clock: advance past recently used slots, clearing their bit, and take
+    // the first free or unreferenced one
+    while (true) {
+        Slot& slot = shard.slots[shard.hand];
+        if (!slot.used || !slot.referenced) break;
+        slot.referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+
+    const size_t victim = shard.hand;
+    Slot& slot = shard.slots[victim];
+    if (slot.used) shard.index.erase(slot.key);
+    slot.key = std::move(key);
+    slot.value = value;
+    slot.used = true;
+    slot.referenced = false;
+    shard.index[slot.key] = victim;
+    shard.hand = (shard.hand + 1) % shard.slots.size();
+    pthread_mutex_unlock(&shard.mutex);
+    return true;
+}
+
+AIResultCache::Stats AIResultCache::get_stats() {
+    Stats stats{0, 0, 0, 0};
+    for (Shard& shard : shards) {
+        pthread_mutex_lock(&shard.mutex);
+        stats.entries += shard.index.size();
+        stats.capacity += shard.slots.size();
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        pthread_mutex_unlock(&shard.mutex);
+    }
+    return stats;
+}
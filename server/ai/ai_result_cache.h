@@ -0,0 +1,110 @@
+#ifndef AI_RESULT_CACHE_H
+#define AI_RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <pthread.h>
+
+#include "chess_ai.h"
+
+// What the AI played in a position after a full search
+struct CachedAIMove {
+    Move move;
+    int score;          // from the side to move's point of view
+    int depth_reached;
+};
+
+// Process-wide cache of finished AI searches, shared by every AI game.
+// Games at the same difficulty often reach the same positions (common
+// opening lines), so a search is reused by key (position hash, difficulty,
+// depth limit) instead of being repeated. The key says nothing about the
+// game's history or evaluation noise, so callers only use the cache where
+// neither can change the result.
+//
+// Bounded: entries live in fixed slots and are evicted with the clock
+// (second chance) algorithm. The key space is split over SHARD_COUNT shards
+// with a mutex each, so workers rarely wait on one another.
+class AIResultCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+    struct Stats {
+        size_t entries;
+        size_t capacity;
+        long long hits;
+        long long misses;
+    };
+
+    ~AIResultCache();
+
+    // Singleton accessor; the cache is created with default settings on first use
+    static AIResultCache* get_instance();
+
+    // Create the cache with room for `capacity` results (0: DEFAULT_CAPACITY).
+    // Has no effect once the cache exists.
+    static void initialize(size_t capacity = 0);
+
+    // Result for the position, if one is cached and its move is legal there.
+    // A cached move that is not legal (a key collision) counts as a miss.
+    bool lookup(const ChessGame& position, const std::string& difficulty, int depth, CachedAIMove& out);
+    // Remember a search of the position. Only results a search reached
+    // within its own limits are kept: book moves are picked at random, and a
+    // search stopped from outside got as deep as its timing allowed.
+    // Returns whether the result was stored.
+    bool store(uint64_t position_key, const std::string& difficulty, int depth, const ChessAIMoveResult& result);
+
+    Stats get_stats();
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;  // one per value of the top four key bits
+
+    struct Key {
+        uint64_t position_key;
+        std::string difficulty;
+        int depth;
+
+        bool operator==(const Key& other) const {
+            return position_key == other.position_key && depth == other.depth && difficulty == other.difficulty;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            // Zobrist keys are already uniform; the rest rarely differs
+            return static_cast<size_t>(key.position_key) ^ (std::hash<std::string>()(key.difficulty) + key.depth);
+        }
+    };
+
+    struct Slot {
+        Key key;
+        CachedAIMove value;
+        bool used;
+        bool referenced;  // looked up since the clock hand last passed
+    };
+
+    struct Shard {
+        pthread_mutex_t mutex;
+        std::unordered_map<Key, size_t, KeyHash> index;  // key -> slot
+        std::vector<Slot> slots;
+        size_t hand;
+        long long hits;
+        long long misses;
+    };
+
+    Shard shards[SHARD_COUNT];
+
+    static AIResultCache* instance;
+    static pthread_mutex_t instance_mutex;
+
+    explicit AIResultCache(size_t capacity);
+
+    Shard& shard_for(uint64_t position_key) {
+        // Top bits, since the low bits pick the hash bucket inside the shard
+        return shards[position_key >> 60];
+    }
+};
+
+#endif // AI_RESULT_CACHE_H
@@ -0,0 +1,161 @@
+#include "ai_worker_pool.h"
+
+#include <exception>
+#include <iostream>
+#include <unistd.h>
+
+AIWorkerPool* AIWorkerPool::instance = nullptr;
+pthread_mutex_t AIWorkerPool::instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+AIWorkerPool::AIWorkerPool(int num_workers, size_t max_queue_depth, int max_search_threads)
+    : max_queue_depth(max_queue_depth),
+      max_search_threads(max_search_threads),
+      stopping(false),
+      busy_workers(0),
+      helper_threads(0),
+      jobs_completed(0),
+      jobs_rejected(0),
+      total_wait_ms(0),
+      max_wait_ms(0) {
+    pthread_mutex_init(&mutex, nullptr);
+    pthread_cond_init(&job_available, nullptr);
+
+    for (int i = 0; i < num_workers; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, worker_main, this) != 0) {
+            std::cerr << "[AIWorkerPool] Failed to create worker thread " << i << std::endl;
+            continue;
+        }
+        workers.push_back(thread);
+    }
+}
+
+AIWorkerPool::~AIWorkerPool() {
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&job_available);
+    pthread_mutex_unlock(&mutex);
+
+    for (pthread_t thread : workers) {
+        pthread_join(thread, nullptr);
+    }
+
+    pthread_cond_destroy(&job_available);
+    pthread_mutex_destroy(&mutex);
+}
+
+AIWorkerPool* AIWorkerPool::get_instance() {
+    initialize();
+    return instance;
+}
+
+void AIWorkerPool::initialize(int num_workers, size_t max_queue_depth, int max_search_threads) {
+    pthread_mutex_lock(&instance_mutex);
+    if (instance == nullptr) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cores <= 0) cores = 1;
+        if (num_workers <= 0) {
+            num_workers = static_cast<int>(cores);
+        }
+        if (max_queue_depth == 0) {
+            max_queue_depth = static_cast<size_t>(num_workers) * QUEUE_SLOTS_PER_WORKER;
+        }
+        if (max_search_threads <= 0) {
+            max_search_threads = static_cast<int>(cores);
+        }
+        instance = new AIWorkerPool(num_workers, max_queue_depth, max_search_threads);
+        std::cout << "[AIWorkerPool] Initialized with " << num_workers << " workers, queue limit "
+                  << max_queue_depth << ", search thread budget " << max_search_threads << std::endl;
+    }
+    pthread_mutex_unlock(&instance_mutex);
+}
+
+bool AIWorkerPool::submit(Job job) {
+    pthread_mutex_lock(&mutex);
+    if (stopping || workers.empty() || queue.size() >= max_queue_depth) {
+        jobs_rejected++;
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
+
+    queue.push_back(QueuedJob{std::move(job), std::chrono::steady_clock::now()});
+    pthread_cond_signal(&job_available);
+    pthread_mutex_unlock(&mutex);
+    return true;
+}
+
+int AIWorkerPool::reserve_helper_threads(int wanted) {
+    if (wanted <= 0) return 0;
+
+    pthread_mutex_lock(&mutex);
+    int available = max_search_threads - busy_workers - helper_threads;
+    int granted = (available < wanted) ? available : wanted;
+    if (granted < 0) granted = 0;
+    helper_threads += granted;
+    pthread_mutex_unlock(&mutex);
+    return granted;
+}
+
+void AIWorkerPool::release_helper_threads(int count) {
+    if (count <= 0) return;
+
+    pthread_mutex_lock(&mutex);
+    helper_threads -= count;
+    pthread_mutex_unlock(&mutex);
+}
+
+AIWorkerPool::Stats AIWorkerPool::get_stats() {
+    pthread_mutex_lock(&mutex);
+    Stats stats;
+    stats.workers = static_cast<int>(workers.size());
+    stats.busy_workers = busy_workers;
+    stats.queue_depth = queue.size();
+    stats.max_queue_depth = max_queue_depth;
+    stats.jobs_completed = jobs_completed;
+    stats.jobs_rejected = jobs_rejected;
+    long long jobs_started = jobs_completed + busy_workers;
+    stats.avg_wait_ms = jobs_started > 0 ? static_cast<double>(total_wait_ms) / jobs_started : 0.0;
+    stats.max_wait_ms = max_wait_ms;
+    stats.helper_threads = helper_threads;
+    stats.max_search_threads = max_search_threads;
+    pthread_mutex_unlock(&mutex);
+    return stats;
+}
+
+void* AIWorkerPool::worker_main(void* arg) {
+    static_cast<AIWorkerPool*>(arg)->run_worker();
+    return nullptr;
+}
+
+void AIWorkerPool::run_worker() {
+    while (true) {
+        pthread_mutex_lock(&mutex);
+        while (queue.empty() && !stopping) {
+            pthread_cond_wait(&job_available, &mutex);
+        }
+        if (stopping) {
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+
+        QueuedJob next = std::move(queue.front());
+        queue.pop_front();
+        long long wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - next.enqueued_at).count();
+        total_wait_ms += wait_ms;
+        if (wait_ms > max_wait_ms) max_wait_ms = wait_ms;
+        busy_workers++;
+        pthread_mutex_unlock(&mutex);
+
+        try {
+            next.job(wait_ms);
+        } catch (const std::exception& e) {
+            std::cerr << "[AIWorkerPool] Job failed: " << e.what() << std::endl;
+        }
+
+        pthread_mutex_lock(&mutex);
+        busy_workers--;
+        jobs_completed++;
+        pthread_mutex_unlock(&mutex);
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef AI_WORKER_POOL_H
+#define AI_WORKER_POOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <pthread.h>
+
+// Fixed-size pool of threads that run AI searches off the client connection
+// threads. Jobs wait in a bounded FIFO queue; when the queue is full submit()
+// refuses the job so the caller can shed load instead of blocking.
+//
+// The pool also owns the server-wide search thread budget: a running job may
+// borrow extra threads for a multi-threaded search, but busy workers plus
+// borrowed threads never exceed max_search_threads.
+class AIWorkerPool {
+public:
+    // A job receives how long it waited in the queue, in milliseconds
+    using Job = std::function<void(long long queue_wait_ms)>;
+
+    struct Stats {
+        int workers;
+        int busy_workers;
+        size_t queue_depth;
+        size_t max_queue_depth;
+        long long jobs_completed;
+        long long jobs_rejected;
+        double avg_wait_ms;
+        long long max_wait_ms;
+        int helper_threads;      // borrowed by running searches
+        int max_search_threads;
+    };
+
+    ~AIWorkerPool();
+
+    // Singleton accessor; the pool is created with default settings on first use
+    static AIWorkerPool* get_instance();
+
+    // Create the pool. num_workers <= 0 uses one worker per online core,
+    // max_queue_depth == 0 allows QUEUE_SLOTS_PER_WORKER jobs per worker and
+    // max_search_threads <= 0 allows one search thread per online core.
+    // Has no effect once the pool exists.
+    static void initialize(int num_workers = 0, size_t max_queue_depth = 0, int max_search_threads = 0);
+
+    // Queue a job; returns false if the queue is full or the pool is stopping
+    bool submit(Job job);
+
+    // Borrow up to `wanted` extra search threads from the budget left over
+    // by busy workers and other searches; returns how many were granted
+    // (possibly 0). Every grant must be returned with release_helper_threads.
+    int reserve_helper_threads(int wanted);
+    void release_helper_threads(int count);
+
+    Stats get_stats();
+
+private:
+    static constexpr size_t QUEUE_SLOTS_PER_WORKER = 16;
+
+    struct QueuedJob {
+        Job job;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
+    std::vector<pthread_t> workers;
+    std::deque<QueuedJob> queue;
+    size_t max_queue_depth;
+    int max_search_threads;
+    bool stopping;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t job_available;
+
+    // Counters, guarded by mutex
+    int busy_workers;
+    int helper_threads;
+    long long jobs_completed;
+    long long jobs_rejected;
+    long long total_wait_ms;
+    long long max_wait_ms;
+
+    static AIWorkerPool* instance;
+    static pthread_mutex_t instance_mutex;
+
+    AIWorkerPool(int num_workers, size_t max_queue_depth, int max_search_threads);
+
+    static void* worker_main(void* arg);
+    void run_worker();
+};
+
+#endif // AI_WORKER_POOL_H
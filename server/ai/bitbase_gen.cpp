@@ -0,0 +1,202 @@
+// Builds the KQK, KRK and KPK endgame tables used by EndgameBitbase.
+//
+// Retrograde analysis over every placement of the two kings and the extra
+// piece (strong side as white), for both sides to move:
+//   - positions where the weak side is checkmated are mate in 0;
+//   - pass n marks a strong-to-move position won in n plies if some move
+//     reaches a position won in n - 1, and a weak-to-move position if every
+//     move reaches a won position and the longest of them is n - 1.
+// Whatever is still unmarked when the passes stop making progress is a draw.
+// Pawn promotions lead into the queen and rook tables, so those are built
+// first; capturing the piece, or promoting to a minor piece, is a draw.
+//
+// Usage:
+//   ./bitbase_gen <endgame.bin>
+
+#include "endgame_bitbase.h"
+
+#include <iostream>
+
+namespace {
+
+// Positions the two sides could not reach in a game
+const uint8_t ILLEGAL = 0xFF;
+
+// Where a move leads
+struct Child {
+    int table;      // TABLE_COUNT: a draw outside the tables
+    size_t index;
+};
+
+Bitboard piece_attacks(PieceType piece, int sq, Bitboard occupied) {
+    switch (piece) {
+        case QUEEN: return queenAttacks(sq, occupied);
+        case ROOK:  return rookAttacks(sq, occupied);
+        default:    return pawnAttacks(WHITE, sq);
+    }
+}
+
+bool is_legal(PieceType piece, int strong_to_move, int strong_king, int weak_king, int piece_sq) {
+    if (strong_king == weak_king || strong_king == piece_sq || weak_king == piece_sq) return false;
+    if (kingAttacks(strong_king) & squareBB(weak_king)) return false;
+    if (piece == PAWN && (rankOf(piece_sq) == 0 || rankOf(piece_sq) == 7)) return false;
+
+    // The side not to move cannot be in check
+    Bitboard occupied = squareBB(strong_king) | squareBB(weak_king) | squareBB(piece_sq);
+    return !(strong_to_move && (piece_attacks(piece, piece_sq, occupied) & squareBB(weak_king)));
+}
+
+// Calls visit(Child) for every legal move of the side to move
+template <typename Visit>
+void for_each_child(PieceType piece, int table, int strong_to_move, int strong_king, int weak_king,
+                    int piece_sq, Visit visit) {
+    const Bitboard occupied = squareBB(strong_king) | squareBB(weak_king) | squareBB(piece_sq);
+
+    if (!strong_to_move) {
+        // Weak king: may not step next to the other king or onto an attacked
+        // square; the piece's rays are taken with the weak king lifted off
+        Bitboard targets = kingAttacks(weak_king) & ~kingAttacks(strong_king);
+        Bitboard without_king = occupied & ~squareBB(weak_king);
+        while (targets) {
+            int to = popLsb(targets);
+            if (to == piece_sq) {
+                visit(Child{TABLE_COUNT, 0});  // captured: bare kings
+            } else if (!(piece_attacks(piece, piece_sq, without_king) & squareBB(to))) {
+                visit(Child{table, EndgameBitbase::index(1, strong_king, to, piece_sq)});
+            }
+        }
+        return;
+    }
+
+    // Strong king
+    Bitboard targets = kingAttacks(strong_king) & ~kingAttacks(weak_king) & ~squareBB(piece_sq);
+    while (targets) {
+        visit(Child{table, EndgameBitbase::index(0, popLsb(targets), weak_king, piece_sq)});
+    }
+
+    if (piece != PAWN) {
+        targets = piece_attacks(piece, piece_sq, occupied) & ~occupied;
+        while (targets) {
+            visit(Child{table, EndgameBitbase::index(0, strong_king, weak_king, popLsb(targets))});
+        }
+        return;
+    }
+
+    // Pawn pushes; the pawn never has anything to capture
+    const int push = piece_sq + 8;
+    if (occupied & squareBB(push)) return;
+    if (rankOf(push) == 7) {
+        visit(Child{TABLE_KQK, EndgameBitbase::index(0, strong_king, weak_king, push)});
+        visit(Child{TABLE_KRK, EndgameBitbase::index(0, strong_king, weak_king, push)});
+        visit(Child{TABLE_COUNT, 0});  // knight or bishop cannot mate
+        return;
+    }
+    visit(Child{table, EndgameBitbase::index(0, strong_king, weak_king, push)});
+    if (rankOf(piece_sq) == 1 && !(occupied & squareBB(push + 8))) {
+        visit(Child{table, EndgameBitbase::index(0, strong_king, weak_king, push + 8)});
+    }
+}
+
+// Fills tables[table]; tables for promotion targets must already be built
+void generate(std::vector<std::vector<uint8_t>>& tables, int table, PieceType piece) {
+    std::vector<uint8_t>& values = tables[table];
+    values.assign(EndgameBitbase::TABLE_SIZE, 0);
+
+    auto value_of = [&](const Child& child) -> int {
+        return child.table == TABLE_COUNT ? 0 : tables[child.table][child.index];
+    };
+
+    // Longest win reachable through a promotion; passes must run past it
+    int longest_other = 0;
+    if (piece == PAWN) {
+        for (int t = TABLE_KQK; t <= TABLE_KRK; t++) {
+            for (uint8_t v : tables[t]) {
+                if (v != ILLEGAL && v > longest_other) longest_other = v;
+            }
+        }
+    }
+
+    // Illegal positions and checkmates
+    for (size_t i = 0; i < EndgameBitbase::TABLE_SIZE; i++) {
+        int piece_sq = i % 64, weak_king = (i / 64) % 64, strong_king = (i / 4096) % 64, stm = int(i / 262144);
+        if (!is_legal(piece, stm, strong_king, weak_king, piece_sq)) {
+            values[i] = ILLEGAL;
+            continue;
+        }
+        if (stm) continue;
+
+        bool has_move = false;
+        for_each_child(piece, table, stm, strong_king, weak_king, piece_sq, [&](const Child&) { has_move = true; });
+        Bitboard occupied = squareBB(strong_king) | squareBB(weak_king) | squareBB(piece_sq);
+        if (!has_move && (piece_attacks(piece, piece_sq, occupied) & squareBB(weak_king))) {
+            values[i] = 1;  // mated: 0 plies + 1
+        }
+    }
+
+    for (int n = 1; n < ILLEGAL - 1; n++) {
+        bool changed = false;
+        for (size_t i = 0; i < EndgameBitbase::TABLE_SIZE; i++) {
+            if (values[i] != 0) continue;
+            int piece_sq = i % 64, weak_king = (i / 64) % 64, strong_king = (i / 4096) % 64, stm = int(i / 262144);
+
+            bool won;
+            if (stm) {
+                // One move into a loss in n - 1 plies
+                won = false;
+                for_each_child(piece, table, stm, strong_king, weak_king, piece_sq,
+                               [&](const Child& c) { won = won || value_of(c) == n; });
+            } else {
+                // Every move loses, the slowest in n - 1 plies
+                bool all_lost = true;
+                int slowest = 0;
+                for_each_child(piece, table, stm, strong_king, weak_king, piece_sq, [&](const Child& c) {
+                    int v = value_of(c);
+                    if (v == 0) all_lost = false;
+                    if (v > slowest) slowest = v;
+                });
+                won = all_lost && slowest == n;
+            }
+            if (won) {
+                values[i] = static_cast<uint8_t>(n + 1);
+                changed = true;
+            }
+        }
+        if (!changed && n > longest_other) break;
+    }
+
+    size_t legal = 0, won = 0;
+    int longest = 0;
+    for (uint8_t& v : values) {
+        if (v == ILLEGAL) {
+            v = 0;  // stored as a draw; never probed
+            continue;
+        }
+        legal++;
+        if (v) won++;
+        if (v > longest) longest = v;
+    }
+    static const char* names[TABLE_COUNT] = {"KQK", "KRK", "KPK"};
+    std::cout << names[table] << ": " << legal << " legal positions, " << won << " won, longest mate "
+              << (longest - 1) << " plies" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <endgame.bin>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> tables(TABLE_COUNT);
+    generate(tables, TABLE_KQK, QUEEN);
+    generate(tables, TABLE_KRK, ROOK);
+    generate(tables, TABLE_KPK, PAWN);
+
+    if (!EndgameBitbase::write(argv[1], tables)) {
+        std::cerr << "Cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << argv[1] << std::endl;
+    return 0;
+}
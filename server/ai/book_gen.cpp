@@ -0,0 +1,93 @@
+// Builds the AI opening book from a text file of opening lines.
+//
+// Each non-empty line not starting with '#' is one line of play from the
+// initial position, as space-separated coordinate moves (e2e4 e7e5 g1f3 ...).
+// Every position along a line gets its next move as a book entry; a move's
+// weight is the number of lines that play it from that position, so common
+// continuations are picked more often.
+//
+// Usage:
+//   ./book_gen <openings.txt> <book.bin> [--max-plies N]   (default 16)
+
+#include "opening_book.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <openings.txt> <book.bin> [--max-plies N]" << std::endl;
+        return 1;
+    }
+
+    int max_plies = 16;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--max-plies" && i + 1 < argc) {
+            max_plies = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // (key, move) -> number of lines playing it
+    std::map<std::pair<uint64_t, uint16_t>, uint32_t> counts;
+    std::string text;
+    int line_number = 0;
+    int lines = 0;
+    int errors = 0;
+
+    while (std::getline(in, text)) {
+        line_number++;
+        if (!text.empty() && text.back() == '\r') text.pop_back();
+        if (text.empty() || text[0] == '#') continue;
+
+        ChessGame game;
+        std::istringstream moves(text);
+        std::string token;
+        int ply = 0;
+        while (ply < max_plies && moves >> token) {
+            // Resolve against the legal moves so the stored encoding
+            // (castling, en passant, promotion) matches the generator's
+            Move played = game.resolveMove(Move::fromString(token));
+            if (played.isNull()) {
+                std::cerr << "Line " << line_number << ": illegal move " << token << " at ply " << ply + 1 << std::endl;
+                errors++;
+                break;
+            }
+
+            counts[{game.getHash(), played.raw()}]++;
+            game.makeMove(played);
+            ply++;
+        }
+        lines++;
+    }
+
+    std::vector<BookEntry> entries;
+    entries.reserve(counts.size());
+    for (const auto& pair : counts) {
+        BookEntry e;
+        e.key = pair.first.first;
+        e.move = pair.first.second;
+        e.weight = static_cast<uint16_t>(pair.second > 0xFFFF ? 0xFFFF : pair.second);
+        e.reserved = 0;
+        entries.push_back(e);
+    }
+
+    if (!OpeningBook::write(argv[2], entries)) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << entries.size() << " entries from " << lines << " lines to " << argv[2] << std::endl;
+    return errors ? 1 : 0;
+}
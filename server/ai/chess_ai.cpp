@@ -2,12 +2,47 @@
 
 #include <algorithm>
 #include <chrono>
-#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
 
-ChessAI::ChessAI(int depth) : depth_(depth) {
+ChessAI::ChessAI(int depth)
+    : depth_(depth),
+      tt_(nullptr),
+      move_time_ms_(SEARCH_TIMEOUT_MS),
+      threads_(1),
+      book_(nullptr),
+      bitbase_(nullptr),
+      node_budget_(0),
+      eval_noise_(0),
+      stop_(nullptr) {
     set_depth(depth);
 }
 
+namespace {
+// Easy plays quickly and often imprecisely; hard is bounded by its node
+// budget long before depth 6 in most middlegames
+const AIDifficulty DIFFICULTIES[] = {
+    {"easy", 2, 2000, 200, 120},
+    {"medium", 4, 20000, 1000, 25},
+    {"hard", 6, 200000, 2000, 0},
+};
+}
+
+const AIDifficulty* ChessAI::find_difficulty(const std::string& name) {
+    for (const AIDifficulty& difficulty : DIFFICULTIES) {
+        if (name == difficulty.name) return &difficulty;
+    }
+    return nullptr;
+}
+
+void ChessAI::set_difficulty(const AIDifficulty& difficulty) {
+    set_depth(difficulty.depth);
+    set_node_budget(difficulty.node_budget);
+    set_move_time_ms(difficulty.move_time_ms);
+    set_eval_noise(difficulty.eval_noise);
+}
+
 void ChessAI::set_depth(int depth) {
     // Depth 1+ only; frontend chooses 2 or 3.
     if (depth < 1) depth = 1;
@@ -19,8 +54,87 @@ int ChessAI::get_depth() const {
     return depth_;
 }
 
+void ChessAI::set_transposition_table(TranspositionTable* tt) {
+    tt_ = tt;
+}
+
+void ChessAI::set_threads(int threads) {
+    threads_ = std::min(std::max(threads, 1), MAX_THREADS);
+}
+
+void ChessAI::set_opening_book(const OpeningBook* book) {
+    book_ = book;
+}
+
+void ChessAI::set_endgame_bitbase(const EndgameBitbase* bitbase) {
+    bitbase_ = bitbase;
+}
+
+void ChessAI::set_move_time_ms(int ms) {
+    move_time_ms_ = std::max(ms, MIN_MOVE_TIME_MS);
+}
+
+void ChessAI::set_node_budget(long long nodes) {
+    node_budget_ = std::max(nodes, 0LL);
+}
+
+void ChessAI::set_eval_noise(int centipawns) {
+    eval_noise_ = std::max(centipawns, 0);
+}
+
+void ChessAI::set_stop_flag(const std::atomic<bool>* stop) {
+    stop_ = stop;
+}
+
+namespace {
+// Endgame bonus for a passed pawn whose next square is empty, by its rank
+// counted from its own side. Depends on the other pieces, so it is added on
+// top of the cached pawn-structure score.
+constexpr int FREE_PASSER_EG[8] = {0, 0, 5, 10, 15, 25, 40, 0};
+
+// Pawn hash table of the calling thread; kept across searches, since pawn
+// structure scores do not depend on the game
+PawnHashTable& thread_pawn_table() {
+    static thread_local PawnHashTable table;
+    return table;
+}
+
+// Helper threads last one move, so their pawn tables are parked here
+// between moves and lent to the next move's helpers still warm
+pthread_mutex_t spare_pawn_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+std::vector<std::unique_ptr<PawnHashTable>> spare_pawn_tables;
+
+PawnHashTable* acquire_pawn_table() {
+    pthread_mutex_lock(&spare_pawn_tables_mutex);
+    PawnHashTable* table = nullptr;
+    if (!spare_pawn_tables.empty()) {
+        table = spare_pawn_tables.back().release();
+        spare_pawn_tables.pop_back();
+    }
+    pthread_mutex_unlock(&spare_pawn_tables_mutex);
+    return table ? table : new PawnHashTable();
+}
+
+void release_pawn_table(PawnHashTable* table) {
+    pthread_mutex_lock(&spare_pawn_tables_mutex);
+    spare_pawn_tables.emplace_back(table);
+    pthread_mutex_unlock(&spare_pawn_tables_mutex);
+}
+
+// Move the hash move (if legal here) to the front of the list
+void order_hash_move_first(MoveList& moves, Move hash_move) {
+    if (hash_move.isNull()) return;
+    for (int i = 1; i < moves.count; i++) {
+        if (moves.moves[i] == hash_move) {
+            std::rotate(moves.moves, moves.moves + i, moves.moves + i + 1);
+            return;
+        }
+    }
+}
+}
+
 ChessAIMoveResult ChessAI::make_move(ChessGame game_state, bool ai_is_white) const {
-    ChessAIMoveResult result{"", 0, 0, false};
+    ChessAIMoveResult result{Move(), 0, 0, false, 0, false, 0, false};
 
     if (game_state.isEnded()) return result;
     if (game_state.isWhiteToMove() != ai_is_white) {
@@ -29,134 +143,464 @@ ChessAIMoveResult ChessAI::make_move(ChessGame game_state, bool ai_is_white) con
     }
 
     const auto start = std::chrono::steady_clock::now();
-    const auto deadline = start + std::chrono::milliseconds(SEARCH_TIMEOUT_MS);
 
-    const auto legal_moves = game_state.getLegalMovesForCurrentPlayer();
+    if (book_) {
+        Move book_move = book_->probe(game_state);
+        if (!book_move.isNull()) {
+            result.move = book_move;
+            result.from_book = true;
+            result.ai_think_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count());
+            return result;
+        }
+    }
+
+    const auto budget = std::chrono::milliseconds(move_time_ms_);
+    std::atomic<bool> abort(false);
+    std::atomic<long long> total_nodes(0);
+    static thread_local std::mt19937_64 seed_rng(std::random_device{}());
+    SearchContext ctx{start + budget, 0, false, &abort, stop_, node_budget_, &total_nodes, 0,
+                      seed_rng(), &thread_pawn_table(), MoveOrderingStats()};
+
+    // An iteration usually takes several times longer than the previous one,
+    // so don't start one once half the budget is gone
+    const auto soft_deadline = start + budget / 2;
+
+    MoveList legal_moves;
+    game_state.generateLegalMoves(legal_moves);
     if (legal_moves.empty()) {
         return result;
     }
 
-    int best_score = std::numeric_limits<int>::min();
-    std::string best_move = legal_moves.front();
-    bool has_candidate_move = false;
-    long long nodes_searched = 0;
-
-    int alpha = std::numeric_limits<int>::min() / 4;
-    int beta = std::numeric_limits<int>::max() / 4;
+    // Root moves are ordered once; later iterations only move the previous
+    // best to the front
+    const uint64_t root_key = game_state.getHash();
+    Move root_hash_move;
+    if (tt_) {
+        tt_->new_search();
+        TTHit hit;
+        if (tt_->probe(root_key, hit)) root_hash_move = hit.move;
+    }
+    {
+        MoveList ordered;
+        MovePicker picker(game_state, legal_moves, root_hash_move, ctx.ordering, 0);
+        for (Move mv; picker.next(mv);) ordered.add(mv);
+        legal_moves = ordered;
+    }
 
-    for (const auto& mv : legal_moves) {
-        if (std::chrono::steady_clock::now() >= deadline) {
-            result.timed_out = true;
-            break;
+    // Lazy SMP helpers; without a shared table they would only repeat the
+    // main thread's work
+    std::vector<std::unique_ptr<HelperSearch>> helpers;
+    if (tt_) {
+        for (int i = 1; i < threads_; i++) {
+            std::unique_ptr<HelperSearch> helper(new HelperSearch{
+                this, game_state, legal_moves, i,
+                SearchContext{ctx.deadline, 0, false, &abort, nullptr, node_budget_, &total_nodes, 0,
+                              ctx.noise_seed, acquire_pawn_table(), MoveOrderingStats()},
+                ChessAIMoveResult{Move(), 0, 0, false, 0, false, 0, false}, pthread_t()});
+            if (pthread_create(&helper->thread, nullptr, helper_main, helper.get()) != 0) {
+                release_pawn_table(helper->ctx.pawns);
+                break;
+            }
+            helpers.push_back(std::move(helper));
         }
+    }
 
-        ChessGame next = game_state;
-        if (!next.move(mv)) {
-            continue;
-        }
+    iterate(game_state, legal_moves, 0, soft_deadline, ctx, result);
+    if (result.timed_out && stop_ && stop_->load(std::memory_order_relaxed)) {
+        // Cut short from outside rather than by the search's own limits
+        result.timed_out = false;
+        result.stopped = true;
+    }
 
-        int score = minimax(next, depth_ - 1, alpha, beta, ai_is_white, 1, deadline, nodes_searched);
+    abort.store(true, std::memory_order_relaxed);
+    result.nodes_searched = ctx.nodes_searched;
+    for (auto& helper : helpers) {
+        pthread_join(helper->thread, nullptr);
+        release_pawn_table(helper->ctx.pawns);
+        result.nodes_searched += helper->ctx.nodes_searched;
 
-        if (!has_candidate_move || score > best_score) {
-            best_score = score;
-            best_move = mv;
-            has_candidate_move = true;
+        // A helper that finished a deeper iteration saw more
+        if (helper->result.depth_reached > result.depth_reached) {
+            result.move = helper->result.move;
+            result.depth_reached = helper->result.depth_reached;
+            result.score = helper->result.score;
         }
-        alpha = std::max(alpha, best_score);
     }
 
     const auto end = std::chrono::steady_clock::now();
     result.ai_think_ms = static_cast<int>(
         std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
-    result.nodes_searched = nodes_searched;
 
-    if (has_candidate_move) {
-        result.move = best_move;
+    return result;
+}
+
+void* ChessAI::helper_main(void* arg) {
+    HelperSearch* helper = static_cast<HelperSearch*>(arg);
+    helper->ai->iterate(helper->position, helper->root_moves, helper->thread_index,
+                        std::chrono::steady_clock::time_point::max(), helper->ctx, helper->result);
+    return nullptr;
+}
+
+void ChessAI::iterate(ChessGame& game_state,
+                      MoveList legal_moves,
+                      int thread_index,
+                      std::chrono::steady_clock::time_point soft_deadline,
+                      SearchContext& ctx,
+                      ChessAIMoveResult& result) const {
+    // Odd helpers run one ply ahead of the main thread so their table
+    // entries are deep enough to cut its searches short
+    const int depth_offset = thread_index % 2;
+    const uint64_t root_key = game_state.getHash();
+
+    // Every move from a covered position leads to another covered one, so
+    // the first iteration already scores the root moves exactly
+    int root_table_score;
+    const bool root_in_bitbase = probe_bitbase(game_state, 0, root_table_score);
+
+    // Always have something to play, even if depth 1 is cut short
+    Move best_move = legal_moves.moves[0];
+
+    for (int depth = 1 + depth_offset; depth <= depth_ + depth_offset; depth++) {
+        int alpha = -INFINITE_SCORE;
+        const int beta = INFINITE_SCORE;
+        int iteration_score = -INFINITE_SCORE;
+        Move iteration_move;
+
+        for (Move mv : legal_moves) {
+            if (out_of_budget(ctx)) {
+                ctx.stopped = true;
+                break;
+            }
+
+            game_state.makeMove(mv);
+            int score;
+            if (iteration_move.isNull()) {
+                score = -negamax(game_state, depth - 1, -beta, -alpha, 1, true, ctx);
+            } else {
+                // Same principal variation search as inside the tree
+                score = -negamax(game_state, depth - 1, -alpha - 1, -alpha, 1, true, ctx);
+                if (score > alpha && !ctx.stopped) {
+                    score = -negamax(game_state, depth - 1, -beta, -alpha, 1, true, ctx);
+                }
+            }
+            game_state.unmakeMove();
+            if (ctx.stopped) break;  // score of an interrupted subtree is meaningless
+
+            if (score > iteration_score) {
+                iteration_score = score;
+                iteration_move = mv;
+            }
+            alpha = std::max(alpha, iteration_score);
+        }
+
+        if (ctx.stopped) {
+            // The previous best was searched first, so any move that finished
+            // with a higher score in this partial iteration is a real improvement
+            if (!iteration_move.isNull()) best_move = iteration_move;
+            result.timed_out = true;
+            break;
+        }
+
+        best_move = iteration_move;
+        result.depth_reached = depth;
+        result.score = iteration_score;
+        if (tt_) {
+            tt_->store(root_key, best_move, score_to_tt(iteration_score, 0), depth, BOUND_EXACT);
+        }
+
+        // A forced mate will not change with more depth
+        if (iteration_score >= MATE_BOUND || iteration_score <= -MATE_BOUND) break;
+        if (root_in_bitbase) break;
+        if (std::chrono::steady_clock::now() >= soft_deadline) break;
+        // Likewise for the node budget, spent by every thread together
+        if (ctx.node_limit) {
+            flush_nodes(ctx);
+            if (ctx.total_nodes->load(std::memory_order_relaxed) >= ctx.node_limit / 2) break;
+        }
+
+        order_hash_move_first(legal_moves, best_move);
     }
 
-    return result;
+    result.move = best_move;
 }
 
-int ChessAI::minimax(ChessGame position,
+bool ChessAI::probe_bitbase(const ChessGame& position, int ply_from_root, int& score) const {
+    BitbaseHit hit;
+    if (!bitbase_ || !bitbase_->probe(position, hit)) return false;
+
+    if (hit.draw) {
+        score = 0;
+    } else {
+        // Same scale as a mate found by search, so shorter mates still score higher
+        const int mate_ply = ply_from_root + hit.plies_to_mate;
+        score = hit.side_to_move_wins ? (MATE_SCORE - mate_ply) : (-MATE_SCORE + mate_ply);
+    }
+    return true;
+}
+
+void ChessAI::flush_nodes(SearchContext& ctx) {
+    ctx.total_nodes->fetch_add(ctx.nodes_searched - ctx.nodes_flushed, std::memory_order_relaxed);
+    ctx.nodes_flushed = ctx.nodes_searched;
+}
+
+bool ChessAI::out_of_budget(SearchContext& ctx) {
+    flush_nodes(ctx);
+    return (ctx.node_limit && ctx.total_nodes->load(std::memory_order_relaxed) >= ctx.node_limit) ||
+           std::chrono::steady_clock::now() >= ctx.deadline ||
+           ctx.abort->load(std::memory_order_relaxed) ||
+           (ctx.stop && ctx.stop->load(std::memory_order_relaxed));
+}
+
+bool ChessAI::should_stop(SearchContext& ctx) {
+    ctx.nodes_searched++;
+    if (!ctx.stopped && ctx.nodes_searched % 64 == 0 && out_of_budget(ctx)) {
+        ctx.stopped = true;
+    }
+    return ctx.stopped;
+}
+
+int ChessAI::negamax(ChessGame& position,
                      int depth_left,
                      int alpha,
                      int beta,
-                     bool ai_is_white,
                      int ply_from_root,
-                     const std::chrono::steady_clock::time_point& deadline,
-                     long long& nodes_searched) const {
-    nodes_searched++;
-    if ((nodes_searched % 64 == 0) && std::chrono::steady_clock::now() >= deadline) {
-        return evaluate_for_ai(position, ai_is_white, ply_from_root);
+                     bool null_move_allowed,
+                     SearchContext& ctx) const {
+    // A repeated position or a spent fifty-move clock is a draw whatever the
+    // material says. Not at the root, which still needs a move to play.
+    if (ply_from_root > 0 && (position.isRepetition() || position.getHalfmoveClock() >= 100)) {
+        ctx.nodes_searched++;
+        return 0;
     }
 
-    if (position.isEnded() || depth_left <= 0) {
-        return evaluate_for_ai(position, ai_is_white, ply_from_root);
+    int table_score;
+    if (probe_bitbase(position, ply_from_root, table_score)) {
+        ctx.nodes_searched++;
+        return table_score;
     }
 
-    const bool side_to_move_is_ai = (position.isWhiteToMove() == ai_is_white);
-    const auto legal_moves = position.getLegalMovesForCurrentPlayer();
+    const bool in_check = position.isKingInCheck(position.isWhiteToMove());
 
-    if (legal_moves.empty()) {
-        // Should usually coincide with isEnded(), but treat as evaluation fallback.
-        return evaluate_for_ai(position, ai_is_white, ply_from_root);
-    }
-
-    if (side_to_move_is_ai) {
-        int best = std::numeric_limits<int>::min();
-        for (const auto& mv : legal_moves) {
-            ChessGame next = position;
-            if (!next.move(mv)) continue;
-
-            best = std::max(best, minimax(next,
-                                          depth_left - 1,
-                                          alpha,
-                                          beta,
-                                          ai_is_white,
-                                          ply_from_root + 1,
-                                          deadline,
-                                          nodes_searched));
-            alpha = std::max(alpha, best);
-            if (beta <= alpha) break;
+    // Check extension: never stand pat in check, and look one ply further
+    // at forcing lines. Bounded so perpetual-check lines cannot run away.
+    if (in_check && ply_from_root < MoveOrderingStats::MAX_PLY / 2) depth_left++;
+
+    if (depth_left <= 0) {
+        return quiescence(position, alpha, beta, ply_from_root, ctx);
+    }
+
+    if (should_stop(ctx) || ply_from_root >= MoveOrderingStats::MAX_PLY - 1) {
+        return evaluate(position, ctx);
+    }
+
+    // Null-window nodes only need a bound, so the table may cut them off
+    // and the riskier pruning below applies to them alone
+    const bool pv_node = (beta - alpha > 1);
+    const int alpha_orig = alpha;
+    const uint64_t key = position.getHash();
+    Move hash_move;
+
+    if (tt_) {
+        TTHit hit;
+        if (tt_->probe(key, hit)) {
+            hash_move = hit.move;
+            if (!pv_node && hit.depth >= depth_left) {
+                const int tt_score = score_from_tt(hit.score, ply_from_root);
+                if (hit.bound == BOUND_EXACT) return tt_score;
+                if (hit.bound == BOUND_LOWER && tt_score >= beta) return tt_score;
+                if (hit.bound == BOUND_UPPER && tt_score <= alpha) return tt_score;
+            }
         }
-        return best;
     }
 
-    int best = std::numeric_limits<int>::max();
-    for (const auto& mv : legal_moves) {
-        ChessGame next = position;
-        if (!next.move(mv)) continue;
+    MoveList legal_moves;
+    position.generateLegalMoves(legal_moves);
+
+    if (legal_moves.empty()) {
+        // Checkmate or stalemate. makeMove() does not update the game-over
+        // state, so score it here; prefer faster mates.
+        return in_check ? (-MATE_SCORE + ply_from_root) : 0;
+    }
+
+    // Null move: if passing still fails high, a real move would too. Not in
+    // check, and not without pieces, where zugzwang makes passing the best
+    // "move" and the test unsound (pawn endings).
+    const int us = position.isWhiteToMove() ? WHITE : BLACK;
+    const Bitboard our_pieces = position.getPieces(us, QUEEN) | position.getPieces(us, ROOK) |
+                                position.getPieces(us, BISHOP) | position.getPieces(us, KNIGHT);
+    if (null_move_allowed && !pv_node && !in_check && our_pieces &&
+        depth_left >= NULL_MOVE_MIN_DEPTH && evaluate(position, ctx) >= beta) {
+        const int reduction = (depth_left >= 7) ? NULL_MOVE_REDUCTION + 1 : NULL_MOVE_REDUCTION;
+
+        position.makeNullMove();
+        int score = -negamax(position, depth_left - 1 - reduction, -beta, -beta + 1, ply_from_root + 1, false, ctx);
+        position.unmakeMove();
+
+        if (ctx.stopped) return 0;
+        // An unproven mate from a null-move search is not trusted
+        if (score >= beta) return (score >= MATE_BOUND) ? beta : score;
+    }
+
+    MovePicker picker(position, legal_moves, hash_move, ctx.ordering, ply_from_root);
+    Move quiets_tried[64];
+    int quiet_count = 0;
+    int move_count = 0;
+
+    int best = -INFINITE_SCORE;
+    Move best_move;
+    for (Move mv; picker.next(mv);) {
+        const bool quiet = MovePicker::is_quiet(position, mv);
+        move_count++;
+
+        position.makeMove(mv);
+        int score;
+        if (move_count == 1) {
+            score = -negamax(position, depth_left - 1, -beta, -alpha, ply_from_root + 1, true, ctx);
+        } else {
+            // Late quiet moves rarely matter once the ordering is good:
+            // search them shallower, and again at full depth if they surprise
+            int reduction = 0;
+            if (quiet && !in_check && depth_left >= LMR_MIN_DEPTH && move_count > LMR_FULL_DEPTH_MOVES &&
+                !position.isKingInCheck(position.isWhiteToMove())) {
+                reduction = (move_count > 2 * LMR_FULL_DEPTH_MOVES + 4 && depth_left >= 5) ? 2 : 1;
+            }
+
+            // Principal variation search: prove the move is no better than
+            // the current best with a null window before a full search
+            score = -negamax(position, depth_left - 1 - reduction, -alpha - 1, -alpha, ply_from_root + 1, true, ctx);
+            if (score > alpha && reduction > 0) {
+                score = -negamax(position, depth_left - 1, -alpha - 1, -alpha, ply_from_root + 1, true, ctx);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(position, depth_left - 1, -beta, -alpha, ply_from_root + 1, true, ctx);
+            }
+        }
+        position.unmakeMove();
+        if (ctx.stopped) return 0;  // caller discards results once stopped
 
-        best = std::min(best, minimax(next,
-                                      depth_left - 1,
-                                      alpha,
-                                      beta,
-                                      ai_is_white,
-                                      ply_from_root + 1,
-                                      deadline,
-                                      nodes_searched));
-        beta = std::min(beta, best);
-        if (beta <= alpha) break;
+        if (score > best) {
+            best = score;
+            best_move = mv;
+        }
+        if (score > alpha) alpha = score;
+
+        if (alpha >= beta) {
+            if (quiet) {
+                ctx.ordering.update_quiet(us, ply_from_root, depth_left, mv, quiets_tried, quiet_count);
+            }
+            break;
+        }
+        if (quiet && quiet_count < 64) quiets_tried[quiet_count++] = mv;
+    }
+
+    if (tt_) {
+        TTBound bound = (best <= alpha_orig) ? BOUND_UPPER
+                      : (best >= beta) ? BOUND_LOWER
+                      : BOUND_EXACT;
+        // No move stood out when every move failed low
+        tt_->store(key, bound == BOUND_UPPER ? Move() : best_move,
+                   score_to_tt(best, ply_from_root), depth_left, bound);
     }
+
     return best;
 }
 
-int ChessAI::evaluate_for_ai(ChessGame position, bool ai_is_white, int ply_from_root) const {
-    if (position.isEnded()) {
-        const auto res = position.getResult();
+int ChessAI::quiescence(ChessGame& position,
+                        int alpha,
+                        int beta,
+                        int ply_from_root,
+                        SearchContext& ctx) const {
+    // Material by PieceType, for delta pruning
+    static const int piece_value[7] = {0, 900, 500, 330, 320, 100, 0};
+
+    if (should_stop(ctx)) {
+        return evaluate(position, ctx);
+    }
+
+    // Captures often simplify into a covered ending
+    int table_score;
+    if (probe_bitbase(position, ply_from_root, table_score)) {
+        return table_score;
+    }
+
+    const bool in_check = position.isKingInCheck(position.isWhiteToMove());
+
+    MoveList legal_moves;
+    position.generateLegalMoves(legal_moves);
+    if (legal_moves.empty()) {
+        return in_check ? (-MATE_SCORE + ply_from_root) : 0;
+    }
+
+    // Stand pat: the side to move may decline every capture. In check that
+    // is not an option, so every evasion is searched instead.
+    const int stand_pat = evaluate(position, ctx);
+    if (ply_from_root >= MoveOrderingStats::MAX_PLY - 1) return stand_pat;
+
+    int best = -INFINITE_SCORE;
+    if (!in_check) {
+        best = stand_pat;
+        if (best >= beta) return best;
+        alpha = std::max(alpha, best);
+    }
 
-        // Large win/loss values; prefer faster mate.
-        const int mate_score = 100000;
-        if (res == WHITE_WIN) {
-            return ai_is_white ? (mate_score - ply_from_root) : (-mate_score + ply_from_root);
+    MovePicker picker(position, legal_moves, Move(), ctx.ordering, ply_from_root);
+    for (Move mv; picker.next(mv);) {
+        if (!in_check) {
+            if (MovePicker::is_quiet(position, mv)) continue;
+            if (mv.kind() == Move::PROMOTION && mv.promotion() != QUEEN) continue;
+
+            // Delta pruning: winning the victim for free would still leave
+            // the score below the window
+            int gain = (mv.kind() == Move::EN_PASSANT) ? piece_value[PAWN] : piece_value[position.pieceOn(mv.to())];
+            if (mv.kind() == Move::PROMOTION) gain += piece_value[mv.promotion()] - piece_value[PAWN];
+            if (stand_pat + gain + DELTA_MARGIN <= alpha) continue;
+            if (position.staticExchange(mv) < 0) continue;
         }
-        if (res == BLACK_WIN) {
-            return ai_is_white ? (-mate_score + ply_from_root) : (mate_score - ply_from_root);
+
+        position.makeMove(mv);
+        int score = -quiescence(position, -beta, -alpha, ply_from_root + 1, ctx);
+        position.unmakeMove();
+
+        if (score > best) best = score;
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
+    }
+
+    return best;
+}
+
+int ChessAI::score_to_tt(int score, int ply_from_root) {
+    if (score >= MATE_BOUND) return score + ply_from_root;
+    if (score <= -MATE_BOUND) return score - ply_from_root;
+    return score;
+}
+
+int ChessAI::score_from_tt(int score, int ply_from_root) {
+    if (score >= MATE_BOUND) return score - ply_from_root;
+    if (score <= -MATE_BOUND) return score + ply_from_root;
+    return score;
+}
+
+int ChessAI::evaluate(const ChessGame& position, SearchContext& ctx) const {
+    const PawnEntry& pawns = ctx.pawns->probe(position);
+    int pawn_eg = pawns.eg;
+    for (int color = WHITE; color <= BLACK; color++) {
+        Bitboard passed = pawns.passed[color];
+        while (passed) {
+            const int sq = popLsb(passed);
+            const int stop = (color == WHITE) ? sq + 8 : sq - 8;
+            if (position.getOccupied() & squareBB(stop)) continue;
+            const int relative_rank = (color == WHITE) ? rankOf(sq) : 7 - rankOf(sq);
+            pawn_eg += (color == WHITE) ? FREE_PASSER_EG[relative_rank] : -FREE_PASSER_EG[relative_rank];
         }
-        return 0;
     }
 
-    // Material only.
-    const int material_white_minus_black = position.evaluateMaterialScore();
-    return ai_is_white ? material_white_minus_black : -material_white_minus_black;
+    int white_minus_black = position.evaluate() + position.taper(pawns.mg, pawn_eg);
+    if (eval_noise_) {
+        // Hash of the position and seed, so transpositions agree within a search
+        const uint64_t h = (position.getHash() ^ ctx.noise_seed) * 0x9E3779B97F4A7C15ULL;
+        white_minus_black += static_cast<int>((h >> 32) % (2 * eval_noise_ + 1)) - eval_noise_;
+    }
+    return position.isWhiteToMove() ? white_minus_black : -white_minus_black;
 }
@@ -1,44 +1,188 @@
 #ifndef CHESS_AI_H
 #define CHESS_AI_H
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <vector>
+#include <pthread.h>
 
 // NOTE: This project currently includes the engine as a .cpp "header".
 #include "../game/chess_game.cpp"
+#include "transposition_table.h"
+#include "move_picker.h"
+#include "pawn_table.h"
+#include "opening_book.h"
+#include "endgame_bitbase.h"
 
 struct ChessAIMoveResult {
-    std::string move;
+    Move move;  // null move only if there are no legal moves
     int ai_think_ms;
     long long nodes_searched;
-    bool timed_out;
+    bool timed_out;      // the time or node budget cut the last iteration short
+    int depth_reached;   // last fully searched depth (0 if none)
+    bool from_book;      // played from the opening book without searching
+    int score;           // of the last full iteration, from the AI's point of view
+    bool stopped;        // the stop flag cut the search short (see set_stop_flag)
+};
+
+// A playing strength offered to players. The node and time budgets bound
+// what one move can cost, whatever the position and thread count, so AI
+// games can be planned per core; the weaker levels also blur the evaluation.
+struct AIDifficulty {
+    const char* name;
+    int depth;              // iterative deepening limit
+    long long node_budget;  // nodes searched per move, all search threads together
+    int move_time_ms;
+    int eval_noise;         // evaluation error of up to +/- this many centipawns
 };
 
 class ChessAI {
 public:
     explicit ChessAI(int depth = 2);
 
+    // Profile for "easy", "medium" or "hard"; nullptr for any other name
+    static const AIDifficulty* find_difficulty(const std::string& name);
+
+    // Depth, node budget, move time and noise from a profile
+    void set_difficulty(const AIDifficulty& difficulty);
+
     void set_depth(int depth);
     int get_depth() const;
 
-    // Returns move in coordinate notation, e.g. "e2e4".
-    // Expects it to be AI's turn; returns "" if no legal moves.
+    // Table used to remember results across nodes and across this game's
+    // moves; nullptr (the default) searches without one. Not owned.
+    void set_transposition_table(TranspositionTable* tt);
+
+    // Search threads including the caller's (Lazy SMP). Extra threads search
+    // the same root at staggered depths and share work only through the
+    // transposition table, so they are used only when one is set.
+    void set_threads(int threads);
+
+    // Book consulted before searching; nullptr (the default) always searches.
+    // Not owned.
+    void set_opening_book(const OpeningBook* book);
+
+    // Endgame tables probed at every node with three or fewer pieces; exact
+    // results replace searching those subtrees. nullptr (the default) or an
+    // unloaded bitbase searches them normally. Not owned.
+    void set_endgame_bitbase(const EndgameBitbase* bitbase);
+
+    // The search never runs past this per-move budget
+    void set_move_time_ms(int ms);
+
+    // Stop once all search threads together have searched this many nodes
+    // (0: no limit)
+    void set_node_budget(long long nodes);
+
+    // Random error added to every static evaluation, fixed per position
+    // within one search (0, the default: exact evaluation)
+    void set_eval_noise(int centipawns);
+
+    // External cancel, e.g. for pondering: once *stop is true the search
+    // unwinds within a few nodes and returns its best move so far.
+    // nullptr (the default) runs to the usual limits. Not owned.
+    void set_stop_flag(const std::atomic<bool>* stop);
+
+    // Expects it to be AI's turn; returns a null move if no legal moves.
+    // Searches depth 1, 2, ... up to the configured depth and returns the
+    // best move of the last completed iteration when time runs out.
+    // The search runs make/unmake on its own copy of game_state; helper
+    // threads get copies of their own and are joined before returning.
     ChessAIMoveResult make_move(ChessGame game_state, bool ai_is_white) const;
 
 private:
-    static constexpr int SEARCH_TIMEOUT_MS = 2000;
+    static constexpr int SEARCH_TIMEOUT_MS = 2000;  // default per-move budget
+    static constexpr int MIN_MOVE_TIME_MS = 10;
+    static constexpr int MATE_SCORE = 100000;
+    static constexpr int MATE_BOUND = MATE_SCORE - 1000;  // |score| above this is a forced mate
+    static constexpr int INFINITE_SCORE = MATE_SCORE + 1;
+    static constexpr int DELTA_MARGIN = 200;  // quiescence: skip captures that cannot reach the window
+    static constexpr int NULL_MOVE_MIN_DEPTH = 3;
+    static constexpr int NULL_MOVE_REDUCTION = 2;  // 3 from depth 7
+    static constexpr int LMR_MIN_DEPTH = 3;
+    static constexpr int LMR_FULL_DEPTH_MOVES = 3;  // moves searched unreduced at each node
+    static constexpr int MAX_THREADS = 64;
+
+    // State shared by every node of one search
+    struct SearchContext {
+        std::chrono::steady_clock::time_point deadline;
+        long long nodes_searched;
+        bool stopped;  // deadline passed; results from here on are unreliable
+        const std::atomic<bool>* abort;  // set when the main thread has finished
+        const std::atomic<bool>* stop;   // external cancel (main thread only); may be null
+        long long node_limit;  // 0: no limit; applies to *total_nodes
+        std::atomic<long long>* total_nodes;  // every thread's nodes, added in batches
+        long long nodes_flushed;  // part of nodes_searched already in *total_nodes
+        uint64_t noise_seed;   // varies the evaluation noise from move to move
+        PawnHashTable* pawns;  // used by this search thread alone
+        MoveOrderingStats ordering;
+    };
+
+    // One Lazy SMP helper: its own position, root moves and context
+    struct HelperSearch {
+        const ChessAI* ai;
+        ChessGame position;
+        MoveList root_moves;
+        int thread_index;
+        SearchContext ctx;
+        ChessAIMoveResult result;
+        pthread_t thread;
+    };
+
     int depth_;
+    TranspositionTable* tt_;
+    int move_time_ms_;
+    int threads_;
+    const OpeningBook* book_;
+    const EndgameBitbase* bitbase_;
+    long long node_budget_;
+    int eval_noise_;
+    const std::atomic<bool>* stop_;
 
-    int minimax(ChessGame position,
+    // Iterative deepening over root_moves (already ordered). Thread 0 is the
+    // main thread; helpers start and finish at staggered depths and ignore
+    // the soft deadline. Fills move, depth_reached and score in result.
+    void iterate(ChessGame& position,
+                 MoveList root_moves,
+                 int thread_index,
+                 std::chrono::steady_clock::time_point soft_deadline,
+                 SearchContext& ctx,
+                 ChessAIMoveResult& result) const;
+    static void* helper_main(void* arg);
+
+    // Exact score of a position the endgame tables cover, from the side to
+    // move's point of view; false if it is not covered
+    bool probe_bitbase(const ChessGame& position, int ply_from_root, int& score) const;
+
+    // True once the deadline, node budget, main thread or stop flag ends the search
+    static bool out_of_budget(SearchContext& ctx);
+    // Adds this thread's nodes since the last call to the shared count
+    static void flush_nodes(SearchContext& ctx);
+    // Counts a node; true once the search has to unwind
+    static bool should_stop(SearchContext& ctx);
+
+    // Negamax principal variation search. Scores are from the side to
+    // move's point of view; null_move_allowed is false right after a pass.
+    int negamax(ChessGame& position,
                 int depth_left,
                 int alpha,
                 int beta,
-                bool ai_is_white,
                 int ply_from_root,
-                const std::chrono::steady_clock::time_point& deadline,
-                long long& nodes_searched) const;
-    int evaluate_for_ai(ChessGame position, bool ai_is_white, int ply_from_root) const;
+                bool null_move_allowed,
+                SearchContext& ctx) const;
+    // Captures and promotions only, until the position is quiet
+    int quiescence(ChessGame& position,
+                   int alpha,
+                   int beta,
+                   int ply_from_root,
+                   SearchContext& ctx) const;
+    // Static evaluation from the side to move's point of view
+    int evaluate(const ChessGame& position, SearchContext& ctx) const;
+
+    // Mate scores are stored relative to the node rather than the root
+    static int score_to_tt(int score, int ply_from_root);
+    static int score_from_tt(int score, int ply_from_root);
 };
 
 #endif
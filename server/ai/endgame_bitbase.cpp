@@ -0,0 +1,134 @@
+#include "endgame_bitbase.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char EndgameBitbase::BITBASE_MAGIC[8];
+
+EndgameBitbase* EndgameBitbase::instance = nullptr;
+pthread_mutex_t EndgameBitbase::instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+EndgameBitbase::EndgameBitbase() : mapping(nullptr), mapping_size(0), tables(nullptr) {}
+
+EndgameBitbase::~EndgameBitbase() {
+    if (mapping) {
+        munmap(const_cast<void*>(mapping), mapping_size);
+    }
+}
+
+EndgameBitbase* EndgameBitbase::get_instance() {
+    pthread_mutex_lock(&instance_mutex);
+    if (instance == nullptr) {
+        instance = new EndgameBitbase();
+    }
+    pthread_mutex_unlock(&instance_mutex);
+    return instance;
+}
+
+bool EndgameBitbase::initialize(const std::string& path) {
+    EndgameBitbase* bitbase = get_instance();
+
+    pthread_mutex_lock(&instance_mutex);
+    bool ok = bitbase->mapping != nullptr || bitbase->map_file(path);
+    pthread_mutex_unlock(&instance_mutex);
+
+    if (ok) {
+        std::cout << "[EndgameBitbase] Loaded KQK/KRK/KPK tables from " << path << std::endl;
+    } else {
+        std::cerr << "[EndgameBitbase] No usable tables at " << path << "; AI will search endgames" << std::endl;
+    }
+    return ok;
+}
+
+bool EndgameBitbase::map_file(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    const size_t expected = sizeof(BitbaseHeader) + TABLE_COUNT * TABLE_SIZE;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expected) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping stays valid
+    if (data == MAP_FAILED) return false;
+
+    const BitbaseHeader* header = static_cast<const BitbaseHeader*>(data);
+    if (std::memcmp(header->magic, BITBASE_MAGIC, sizeof(BITBASE_MAGIC)) != 0 ||
+        header->version != BITBASE_VERSION || header->table_count != TABLE_COUNT) {
+        munmap(data, expected);
+        return false;
+    }
+
+    mapping = data;
+    mapping_size = expected;
+    tables = static_cast<const uint8_t*>(data) + sizeof(BitbaseHeader);
+    return true;
+}
+
+bool EndgameBitbase::probe(const ChessGame& position, BitbaseHit& out) const {
+    const int piece_count = popCount(position.getOccupied());
+    if (piece_count > 3) return false;
+
+    out.draw = true;
+    out.side_to_move_wins = false;
+    out.plies_to_mate = 0;
+    if (piece_count == 2) return true;  // bare kings
+
+    // Find the extra piece and its owner
+    int strong = WHITE;
+    PieceType piece = NONE;
+    for (int color = WHITE; color <= BLACK && piece == NONE; color++) {
+        for (int p = QUEEN; p <= PAWN; p++) {
+            if (position.getPieces(color, static_cast<PieceType>(p))) {
+                strong = color;
+                piece = static_cast<PieceType>(p);
+                break;
+            }
+        }
+    }
+    if (piece == BISHOP || piece == KNIGHT) return true;  // cannot mate
+    if (!tables) return false;
+
+    const EndgameTable table = (piece == QUEEN) ? TABLE_KQK : (piece == ROOK) ? TABLE_KRK : TABLE_KPK;
+
+    // Tables have the strong side as white; flip the board otherwise
+    const int flip = (strong == WHITE) ? 0 : 56;
+    const int strong_king = lsb(position.getPieces(strong, KING)) ^ flip;
+    const int weak_king = lsb(position.getPieces(strong ^ 1, KING)) ^ flip;
+    const int piece_sq = lsb(position.getPieces(strong, piece)) ^ flip;
+    const bool strong_to_move = (position.isWhiteToMove() == (strong == WHITE));
+
+    const uint8_t value = tables[table * TABLE_SIZE + index(strong_to_move, strong_king, weak_king, piece_sq)];
+    if (value != 0) {
+        out.draw = false;
+        out.side_to_move_wins = strong_to_move;
+        out.plies_to_mate = value - 1;
+    }
+    return true;
+}
+
+bool EndgameBitbase::write(const std::string& path, const std::vector<std::vector<uint8_t>>& tables) {
+    if (tables.size() != TABLE_COUNT) return false;
+
+    BitbaseHeader header;
+    std::memcpy(header.magic, BITBASE_MAGIC, sizeof(BITBASE_MAGIC));
+    header.version = BITBASE_VERSION;
+    header.table_count = TABLE_COUNT;
+
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    for (const auto& table : tables) {
+        ok = ok && table.size() == TABLE_SIZE && std::fwrite(table.data(), 1, TABLE_SIZE, out) == TABLE_SIZE;
+    }
+    ok = (std::fclose(out) == 0) && ok;
+    return ok;
+}
@@ -0,0 +1,87 @@
+#ifndef ENDGAME_BITBASE_H
+#define ENDGAME_BITBASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "../game/chess_game.cpp"
+
+// Endgames covered by the tables: a lone king against king and one piece.
+// The order is the order of the tables in the file.
+enum EndgameTable : uint8_t {
+    TABLE_KQK,
+    TABLE_KRK,
+    TABLE_KPK,
+    TABLE_COUNT
+};
+
+// File layout (native little-endian): BitbaseHeader, then TABLE_COUNT
+// tables of TABLE_SIZE bytes each, indexed by EndgameBitbase::index().
+struct BitbaseHeader {
+    char magic[8];          // BITBASE_MAGIC
+    uint32_t version;       // BITBASE_VERSION
+    uint32_t table_count;
+};
+
+static_assert(sizeof(BitbaseHeader) == 16, "BitbaseHeader layout is part of the file format");
+
+// Result of a probe, from the side to move's point of view
+struct BitbaseHit {
+    bool draw;
+    bool side_to_move_wins;
+    int plies_to_mate;      // when not a draw; 0 means the side to move is mated
+};
+
+// Precomputed results for KQK, KRK and KPK, memory-mapped once and shared by
+// every AI thread. Each position holds one byte rather than one bit: 0 for a
+// draw (or a position that cannot occur), otherwise plies to mate + 1. A
+// plain win/draw bit would say the ending is won but not which move makes
+// progress. Built offline by bitbase_gen.
+//
+// Tables are stored with the stronger side as white; positions where black
+// has the extra piece are probed with the board flipped.
+class EndgameBitbase {
+public:
+    static constexpr char BITBASE_MAGIC[8] = {'N', 'P', 'C', 'H', 'E', 'G', 'B', 'B'};
+    static constexpr uint32_t BITBASE_VERSION = 1;
+    static constexpr size_t TABLE_SIZE = 2 * 64 * 64 * 64;
+
+    // strong_to_move is 1 when the side with the extra piece is to move
+    static size_t index(int strong_to_move, int strong_king, int weak_king, int piece_sq) {
+        return ((static_cast<size_t>(strong_to_move) * 64 + strong_king) * 64 + weak_king) * 64 + piece_sq;
+    }
+
+    ~EndgameBitbase();
+
+    // Singleton accessor; empty (every probe misses) until initialize()
+    static EndgameBitbase* get_instance();
+
+    // Map the tables at path. Returns false (and stays empty) if the file is
+    // missing or malformed. Has no effect once tables are mapped.
+    static bool initialize(const std::string& path);
+
+    // True if the position is covered: one of the table endings, or bare
+    // kings / king and minor piece against king (always drawn)
+    bool probe(const ChessGame& position, BitbaseHit& out) const;
+
+    bool loaded() const { return tables != nullptr; }
+
+    // Write a tables file (used by bitbase_gen); tables[t] has TABLE_SIZE bytes
+    static bool write(const std::string& path, const std::vector<std::vector<uint8_t>>& tables);
+
+private:
+    const void* mapping;
+    size_t mapping_size;
+    const uint8_t* tables;
+
+    static EndgameBitbase* instance;
+    static pthread_mutex_t instance_mutex;
+
+    EndgameBitbase();
+    bool map_file(const std::string& path);
+};
+
+#endif // ENDGAME_BITBASE_H
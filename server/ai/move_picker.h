@@ -0,0 +1,132 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include <cstdlib>
+
+#include "../game/chess_game.cpp"
+
+// Move ordering for the AI search.
+//
+// The generator produces every legal move at once, so the stages are score
+// bands rather than separate generation passes:
+//   1. hash move from the transposition table
+//   2. captures and queen promotions that do not lose material (by SEE),
+//      most valuable victim / least valuable attacker first
+//   3. killer moves (quiet moves that caused a cutoff at the same ply)
+//   4. other quiet moves by history score
+//   5. losing captures, then underpromotions
+// next() selects the best remaining move each call, so a cutoff after the
+// first few moves saves sorting the rest.
+
+// Killer moves and history scores collected during one search
+struct MoveOrderingStats {
+    static constexpr int MAX_PLY = 128;
+    static constexpr int HISTORY_MAX = 1 << 14;
+
+    Move killers[MAX_PLY][2];
+    int history[2][64][64];  // [Color][from][to]
+
+    void clear() {
+        for (auto& k : killers) k[0] = k[1] = Move();
+        for (auto& by_from : history)
+            for (auto& by_to : by_from)
+                for (int& h : by_to) h = 0;
+    }
+
+    // Reward the quiet move that caused a cutoff and penalise the quiet moves
+    // tried before it. The update saturates so scores stay within HISTORY_MAX.
+    void update_quiet(int color, int ply, int depth, Move best, const Move* tried, int tried_count) {
+        int bonus = depth * depth;
+        if (bonus > 400) bonus = 400;
+
+        add_history(history[color][best.from()][best.to()], bonus);
+        for (int i = 0; i < tried_count; i++) {
+            if (tried[i] != best) add_history(history[color][tried[i].from()][tried[i].to()], -bonus);
+        }
+
+        if (ply < MAX_PLY && killers[ply][0] != best) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = best;
+        }
+    }
+
+private:
+    static void add_history(int& entry, int bonus) {
+        entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+    }
+};
+
+class MovePicker {
+public:
+    // Quiet moves are not captures or promotions
+    static bool is_quiet(const ChessGame& position, Move m) {
+        return m.kind() != Move::PROMOTION && !position.isCapture(m);
+    }
+
+    MovePicker(const ChessGame& position, MoveList& moves, Move hash_move,
+               const MoveOrderingStats& stats, int ply)
+        : moves_(moves), next_(0) {
+        const int color = position.isWhiteToMove() ? WHITE : BLACK;
+        const Move* killers = (ply < MoveOrderingStats::MAX_PLY) ? stats.killers[ply] : nullptr;
+
+        for (int i = 0; i < moves_.count; i++) {
+            const Move m = moves_.moves[i];
+            int score;
+            if (m == hash_move) {
+                score = HASH_SCORE;
+            } else if (m.kind() == Move::PROMOTION && m.promotion() != QUEEN) {
+                score = UNDERPROMOTION_SCORE;
+            } else if (!is_quiet(position, m)) {
+                score = capture_score(position, m);
+            } else if (killers && m == killers[0]) {
+                score = KILLER_SCORE + 1;
+            } else if (killers && m == killers[1]) {
+                score = KILLER_SCORE;
+            } else {
+                score = stats.history[color][m.from()][m.to()];
+            }
+            scores_[i] = score;
+        }
+    }
+
+    // Next move in order; false once every move has been returned
+    bool next(Move& out) {
+        if (next_ >= moves_.count) return false;
+
+        int best = next_;
+        for (int i = next_ + 1; i < moves_.count; i++) {
+            if (scores_[i] > scores_[best]) best = i;
+        }
+        std::swap(moves_.moves[next_], moves_.moves[best]);
+        std::swap(scores_[next_], scores_[best]);
+        out = moves_.moves[next_++];
+        return true;
+    }
+
+private:
+    static constexpr int HASH_SCORE = 1 << 30;
+    static constexpr int GOOD_CAPTURE_SCORE = 1 << 28;
+    static constexpr int KILLER_SCORE = 1 << 27;
+    static constexpr int BAD_CAPTURE_SCORE = -(1 << 28);
+    static constexpr int UNDERPROMOTION_SCORE = -(1 << 29);
+
+    MoveList& moves_;
+    int scores_[MoveList::MAX_MOVES];
+    int next_;
+
+    static int capture_score(const ChessGame& position, Move m) {
+        // Ordering rank by PieceType: KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN, NONE
+        static const int rank[7] = {6, 5, 4, 3, 2, 1, 0};
+
+        int attacker = position.pieceOn(m.from());
+        int victim = (m.kind() == Move::EN_PASSANT) ? PAWN : position.pieceOn(m.to());
+        int mvv_lva = rank[victim] * 8 - rank[attacker];
+        if (m.kind() == Move::PROMOTION) mvv_lva += rank[QUEEN] * 8;
+
+        // Taking an equal or bigger piece can never lose material
+        bool good = (rank[attacker] <= rank[victim] && attacker != KING) || position.staticExchange(m) >= 0;
+        return (good ? GOOD_CAPTURE_SCORE : BAD_CAPTURE_SCORE) + mvv_lva;
+    }
+};
+
+#endif // MOVE_PICKER_H
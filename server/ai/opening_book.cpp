@@ -0,0 +1,133 @@
+#include "opening_book.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char OpeningBook::BOOK_MAGIC[8];
+
+OpeningBook* OpeningBook::instance = nullptr;
+pthread_mutex_t OpeningBook::instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+OpeningBook::OpeningBook() : mapping(nullptr), mapping_size(0), entries(nullptr), entry_count(0) {}
+
+OpeningBook::~OpeningBook() {
+    if (mapping) {
+        munmap(const_cast<void*>(mapping), mapping_size);
+    }
+}
+
+OpeningBook* OpeningBook::get_instance() {
+    pthread_mutex_lock(&instance_mutex);
+    if (instance == nullptr) {
+        instance = new OpeningBook();
+    }
+    pthread_mutex_unlock(&instance_mutex);
+    return instance;
+}
+
+bool OpeningBook::initialize(const std::string& path) {
+    OpeningBook* book = get_instance();
+
+    pthread_mutex_lock(&instance_mutex);
+    bool ok = book->mapping != nullptr || book->map_file(path);
+    pthread_mutex_unlock(&instance_mutex);
+
+    if (ok) {
+        std::cout << "[OpeningBook] Loaded " << book->entry_count << " entries from " << path << std::endl;
+    } else {
+        std::cerr << "[OpeningBook] No usable book at " << path << "; AI will search every move" << std::endl;
+    }
+    return ok;
+}
+
+bool OpeningBook::map_file(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(BookHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping stays valid
+    if (data == MAP_FAILED) return false;
+
+    const BookHeader* header = static_cast<const BookHeader*>(data);
+    if (std::memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        header->version != BOOK_VERSION ||
+        size != sizeof(BookHeader) + static_cast<size_t>(header->entry_count) * sizeof(BookEntry)) {
+        munmap(data, size);
+        return false;
+    }
+
+    mapping = data;
+    mapping_size = size;
+    entries = reinterpret_cast<const BookEntry*>(static_cast<const char*>(data) + sizeof(BookHeader));
+    entry_count = header->entry_count;
+    return true;
+}
+
+Move OpeningBook::probe(const ChessGame& position) const {
+    if (entry_count == 0) return Move();
+
+    const uint64_t key = position.getHash();
+    const BookEntry* end = entries + entry_count;
+    const BookEntry* first = std::lower_bound(entries, end, key,
+        [](const BookEntry& e, uint64_t k) { return e.key < k; });
+    if (first == end || first->key != key) return Move();
+
+    // Only moves that are legal here count; guards against hash collisions
+    MoveList legal_moves;
+    position.generateLegalMoves(legal_moves);
+
+    Move candidates[MoveList::MAX_MOVES];
+    uint32_t weights[MoveList::MAX_MOVES];
+    int count = 0;
+    uint32_t total = 0;
+    for (const BookEntry* e = first; e != end && e->key == key && count < MoveList::MAX_MOVES; ++e) {
+        if (e->weight == 0) continue;
+        Move m = Move::fromRaw(e->move);
+        if (std::find(legal_moves.begin(), legal_moves.end(), m) == legal_moves.end()) continue;
+        candidates[count] = m;
+        weights[count] = e->weight;
+        total += e->weight;
+        count++;
+    }
+    if (total == 0) return Move();
+
+    static thread_local std::mt19937 rng(std::random_device{}());
+    uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(rng);
+    for (int i = 0; i < count; i++) {
+        if (pick < weights[i]) return candidates[i];
+        pick -= weights[i];
+    }
+    return candidates[count - 1];
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<BookEntry> entries) {
+    std::sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    BookHeader header;
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.entry_count = static_cast<uint32_t>(entries.size());
+
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              (entries.empty() || std::fwrite(entries.data(), sizeof(BookEntry), entries.size(), out) == entries.size());
+    ok = (std::fclose(out) == 0) && ok;
+    return ok;
+}
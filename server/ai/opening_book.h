@@ -0,0 +1,70 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "../game/chess_game.cpp"
+
+// Opening book file layout (native little-endian):
+//   BookHeader, then entry_count BookEntry records sorted by key, then move.
+// Keys are ChessGame::getHash() values. The Zobrist keys are fixed at compile
+// time, so a book stays valid across builds as long as zobrist.h is unchanged.
+struct BookHeader {
+    char magic[8];          // BOOK_MAGIC
+    uint32_t version;       // BOOK_VERSION
+    uint32_t entry_count;
+};
+
+struct BookEntry {
+    uint64_t key;
+    uint16_t move;          // Move::raw()
+    uint16_t weight;        // relative frequency; 0 never plays the move
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BookHeader) == 16, "BookHeader layout is part of the file format");
+static_assert(sizeof(BookEntry) == 16, "BookEntry layout is part of the file format");
+
+// Read-only opening book, memory-mapped once and shared by every AI thread.
+// Probing does not lock: the mapping never changes after initialize().
+class OpeningBook {
+public:
+    static constexpr char BOOK_MAGIC[8] = {'N', 'P', 'C', 'H', 'B', 'O', 'O', 'K'};
+    static constexpr uint32_t BOOK_VERSION = 1;
+
+    ~OpeningBook();
+
+    // Singleton accessor; an empty book until initialize() maps a file
+    static OpeningBook* get_instance();
+
+    // Map the book at path. Returns false (and keeps an empty book) if the
+    // file is missing or malformed. Has no effect once a book is mapped.
+    static bool initialize(const std::string& path);
+
+    // A book move for the position, picked at random by weight among the
+    // legal book moves; null move if the position is not in the book
+    Move probe(const ChessGame& position) const;
+
+    size_t size() const { return entry_count; }
+
+    // Sort entries by key and write a book file (used by book_gen)
+    static bool write(const std::string& path, std::vector<BookEntry> entries);
+
+private:
+    const void* mapping;
+    size_t mapping_size;
+    const BookEntry* entries;
+    size_t entry_count;
+
+    static OpeningBook* instance;
+    static pthread_mutex_t instance_mutex;
+
+    OpeningBook();
+    bool map_file(const std::string& path);
+};
+
+#endif // OPENING_BOOK_H
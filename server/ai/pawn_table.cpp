@@ -0,0 +1,78 @@
+#include "pawn_table.h"
+
+namespace {
+constexpr int DOUBLED_MG = 10, DOUBLED_EG = 20;    // per extra pawn on a file
+constexpr int ISOLATED_MG = 10, ISOLATED_EG = 15;
+// Passed pawn bonus by rank counted from the pawn's own side
+constexpr int PASSED_MG[8] = {0, 0, 5, 10, 20, 35, 55, 0};
+constexpr int PASSED_EG[8] = {0, 5, 10, 20, 35, 55, 80, 0};
+
+Bitboard adjacent_files(int file) {
+    Bitboard b = 0;
+    if (file > 0) b |= FILE_A_BB << (file - 1);
+    if (file < 7) b |= FILE_A_BB << (file + 1);
+    return b;
+}
+
+// Every square strictly in front of `rank` from `color`'s point of view
+Bitboard ranks_ahead(int color, int rank) {
+    if (color == WHITE) return rank < 7 ? ~0ULL << (8 * (rank + 1)) : 0;
+    return rank > 0 ? (1ULL << (8 * rank)) - 1 : 0;
+}
+}
+
+PawnHashTable::PawnHashTable() : entries_(new PawnEntry[ENTRY_COUNT]()) {}
+
+const PawnEntry& PawnHashTable::probe(const ChessGame& position) {
+    const uint64_t key = position.getPawnKey();
+    PawnEntry& entry = entries_[key & (ENTRY_COUNT - 1)];
+    if (entry.key == key) return entry;
+
+    entry.key = key;
+    evaluate(position, entry);
+    return entry;
+}
+
+void PawnHashTable::evaluate(const ChessGame& position, PawnEntry& entry) {
+    int mg = 0;
+    int eg = 0;
+
+    for (int color = WHITE; color <= BLACK; color++) {
+        const int sign = (color == WHITE) ? 1 : -1;
+        const Bitboard ours = position.getPieces(color, PAWN);
+        const Bitboard theirs = position.getPieces(color ^ 1, PAWN);
+        entry.passed[color] = 0;
+
+        for (int file = 0; file < 8; file++) {
+            int on_file = popCount(ours & (FILE_A_BB << file));
+            if (on_file > 1) {
+                mg -= sign * DOUBLED_MG * (on_file - 1);
+                eg -= sign * DOUBLED_EG * (on_file - 1);
+            }
+        }
+
+        Bitboard b = ours;
+        while (b) {
+            const int sq = popLsb(b);
+            const int file = fileOf(sq);
+            const Bitboard neighbours = adjacent_files(file);
+
+            if (!(ours & neighbours)) {
+                mg -= sign * ISOLATED_MG;
+                eg -= sign * ISOLATED_EG;
+            }
+
+            // No enemy pawn ahead on this or an adjacent file can stop it
+            const Bitboard front_span = ranks_ahead(color, rankOf(sq)) & (neighbours | (FILE_A_BB << file));
+            if (!(theirs & front_span)) {
+                const int relative_rank = (color == WHITE) ? rankOf(sq) : 7 - rankOf(sq);
+                entry.passed[color] |= squareBB(sq);
+                mg += sign * PASSED_MG[relative_rank];
+                eg += sign * PASSED_EG[relative_rank];
+            }
+        }
+    }
+
+    entry.mg = static_cast<int16_t>(mg);
+    entry.eg = static_cast<int16_t>(eg);
+}
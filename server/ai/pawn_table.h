@@ -0,0 +1,41 @@
+#ifndef PAWN_TABLE_H
+#define PAWN_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "../game/chess_game.cpp"
+
+// Cached pawn-structure evaluation for one pawn configuration
+struct PawnEntry {
+    uint64_t key;         // pawn-only Zobrist key
+    Bitboard passed[2];   // [Color] passed pawns
+    int16_t mg;           // doubled/isolated/passed terms, white minus black
+    int16_t eg;
+};
+
+// Direct-mapped cache of pawn-structure scores keyed by the pawn-only
+// Zobrist key. Pawns move rarely, so nearly every probe in a search hits.
+//
+// Not thread-safe: each search thread uses its own table. Helper threads
+// borrow theirs from a shared pool (see ChessAI::make_move).
+//
+// A zeroed entry is the correct result for a position without pawns, so
+// the table needs no separate "empty" marker.
+class PawnHashTable {
+public:
+    static constexpr size_t ENTRY_COUNT = 4096;  // 128 KB
+
+    PawnHashTable();
+
+    // Entry for the position's pawns, evaluated and stored on a miss
+    const PawnEntry& probe(const ChessGame& position);
+
+private:
+    std::unique_ptr<PawnEntry[]> entries_;
+
+    static void evaluate(const ChessGame& position, PawnEntry& entry);
+};
+
+#endif // PAWN_TABLE_H
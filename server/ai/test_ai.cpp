@@ -0,0 +1,248 @@
+// AI regression tests: search results for positions with a known answer,
+// endgame bitbase and opening book probes, and the shared result cache.
+// No database dependencies. Run from the server directory after
+// `make book bitbases` (or just `make test`).
+//
+// Usage:
+//   ./test_ai
+
+#include "chess_ai.h"
+#include "opening_book.h"
+#include "endgame_bitbase.h"
+#include "ai_result_cache.h"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace {
+
+// ChessAI scores a mate found n plies from the root as MATE_SCORE - n
+const int MATE_SCORE = 100000;
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) failures++;
+    std::cout << (ok ? "✓ " : "✗ ") << what << std::endl;
+}
+
+ChessGame load(const std::string& fen) {
+    ChessGame game;
+    if (!game.loadFEN(fen)) std::cout << "  could not load FEN: " << fen << std::endl;
+    return game;
+}
+
+// Search fen to a fixed depth with its own table and no time pressure
+ChessAIMoveResult search(const std::string& fen, int depth) {
+    ChessGame game = load(fen);
+    TranspositionTable tt(1);
+    ChessAI ai(depth);
+    ai.set_transposition_table(&tt);
+    ai.set_move_time_ms(60000);
+    return ai.make_move(game, game.isWhiteToMove());
+}
+
+void testMates() {
+    std::cout << "Test: forced mates..." << std::endl;
+
+    struct MateCase {
+        const char* fen;
+        int depth;
+        const char* move;   // empty when several moves mate equally fast
+        int mate_in;
+    };
+    const MateCase cases[] = {
+        {"6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", 3, "a1a8", 1},
+        {"r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4", 3, "h5f7", 1},
+        {"r5k1/5ppp/8/8/8/8/1R3PPP/1R4K1 w - - 0 1", 4, "b2b8", 2},
+        {"8/8/8/8/8/8/8/k1KR4 w - - 0 1", 5, "", 3},
+        {"8/2P5/8/8/8/8/8/k1K5 w - - 0 1", 6, "", 3},
+    };
+
+    for (const MateCase& c : cases) {
+        ChessAIMoveResult r = search(c.fen, c.depth);
+        const int expected = MATE_SCORE - (2 * c.mate_in - 1);
+        const bool move_ok = c.move[0] == '\0' || r.move.toString() == c.move;
+        check(move_ok && r.score == expected,
+              "mate in " + std::to_string(c.mate_in) + " (" + r.move.toString() + ", " +
+              std::to_string(r.score) + "): " + c.fen);
+    }
+}
+
+void testDraws() {
+    std::cout << "Test: draws inside the search..." << std::endl;
+
+    // Two queens down, but Qe8+ Kh7 Qh5+ Kg8 repeats forever
+    ChessAIMoveResult r = search("6k1/6p1/8/7Q/8/8/qq3PPP/6K1 w - - 0 1", 5);
+    check(r.move.toString() == "h5e8" && r.score == 0,
+          "perpetual check is found and scored as a draw (" + r.move.toString() + ", " +
+          std::to_string(r.score) + ")");
+
+    // Any move without a capture or pawn move reaches the hundredth ply
+    r = search("8/8/8/4k3/8/8/3QK3/8 w - - 99 80", 3);
+    check(!r.move.isNull() && r.score == 0,
+          "fifty-move rule caps a winning score at a draw (" + std::to_string(r.score) + ")");
+}
+
+void testBitbase() {
+    std::cout << "Test: endgame bitbase..." << std::endl;
+
+    if (!EndgameBitbase::initialize("config/endgame_bitbase.bin")) {
+        check(false, "config/endgame_bitbase.bin loads (run `make bitbases`)");
+        return;
+    }
+    EndgameBitbase* bitbase = EndgameBitbase::get_instance();
+
+    struct BitbaseCase {
+        const char* fen;
+        bool draw;
+        bool side_to_move_wins;
+        int plies_to_mate;
+    };
+    // Longest wins are the textbook mates in 10 (KQK), 16 (KRK) and 28 (KPK)
+    const BitbaseCase cases[] = {
+        {"8/8/8/5k2/8/8/1Q6/K7 w - - 0 1", false, true, 19},
+        {"8/8/8/8/4k3/8/1Q6/K7 b - - 0 1", false, false, 20},
+        {"k7/1q6/8/8/5K2/8/8/8 b - - 0 1", false, true, 19},
+        {"8/8/8/8/8/2k5/1R6/K7 w - - 0 1", false, true, 31},
+        {"8/8/8/8/8/8/1Rk5/K7 b - - 0 1", false, false, 32},
+        {"5k2/8/5K2/8/8/8/8/R7 w - - 0 1", false, true, 1},
+        {"8/8/8/8/8/8/8/k1KR4 w - - 0 1", false, true, 5},
+        {"8/8/8/1k6/8/8/K5P1/8 w - - 0 1", false, true, 55},
+        {"8/8/8/k7/8/K7/6P1/8 b - - 0 1", false, false, 56},
+        {"k7/8/8/8/8/8/P7/K7 w - - 0 1", true, false, 0},
+    };
+
+    for (const BitbaseCase& c : cases) {
+        ChessGame game = load(c.fen);
+        BitbaseHit hit{};
+        bool found = bitbase->probe(game, hit);
+        bool ok = found && hit.draw == c.draw;
+        if (ok && !c.draw) ok = hit.side_to_move_wins == c.side_to_move_wins && hit.plies_to_mate == c.plies_to_mate;
+        std::string got = !found ? "miss" : hit.draw ? "draw" :
+                          std::string(hit.side_to_move_wins ? "win" : "loss") + " in " + std::to_string(hit.plies_to_mate);
+        check(ok, got + ": " + c.fen);
+    }
+
+    BitbaseHit hit{};
+    check(!bitbase->probe(ChessGame(), hit), "positions with more material miss");
+}
+
+void testBook() {
+    std::cout << "Test: opening book..." << std::endl;
+
+    if (!OpeningBook::initialize("config/opening_book.bin")) {
+        check(false, "config/opening_book.bin loads (run `make book`)");
+        return;
+    }
+    OpeningBook* book = OpeningBook::get_instance();
+
+    // Replay the first plies of every line to learn which continuations the
+    // book may offer in each position it was built from
+    std::ifstream in("config/openings.txt");
+    std::map<uint64_t, std::set<std::string>> continuations;
+    std::map<uint64_t, ChessGame> positions;
+    std::string text;
+    while (std::getline(in, text)) {
+        if (!text.empty() && text.back() == '\r') text.pop_back();
+        if (text.empty() || text[0] == '#') continue;
+
+        ChessGame game;
+        std::istringstream moves(text);
+        std::string token;
+        for (int ply = 0; ply < 6 && moves >> token; ply++) {
+            Move played = game.resolveMove(Move::fromString(token));
+            if (played.isNull()) break;
+            continuations[game.getHash()].insert(played.toString());
+            positions.emplace(game.getHash(), game);
+            game.makeMove(played);
+        }
+    }
+    check(!continuations.empty(), "config/openings.txt has lines to check against");
+
+    int probed = 0;
+    int offbook = 0;
+    for (const auto& pair : positions) {
+        const std::set<std::string>& allowed = continuations[pair.first];
+        for (int i = 0; i < 8; i++) {
+            Move m = book->probe(pair.second);
+            probed++;
+            if (m.isNull() || !allowed.count(m.toString())) offbook++;
+        }
+    }
+    check(offbook == 0, "book moves come from the source lines (" + std::to_string(offbook) + " of " +
+                        std::to_string(probed) + " probes off book)");
+
+    ChessGame unusual = load("rnbqkbnr/pppppppp/8/8/7P/8/PPPPPPP1/RNBQKBNR b KQkq - 0 1");
+    check(book->probe(unusual).isNull(), "a position outside the book misses");
+}
+
+void testResultCache() {
+    std::cout << "Test: AI result cache..." << std::endl;
+
+    AIResultCache::initialize(64);
+    AIResultCache* cache = AIResultCache::get_instance();
+
+    ChessGame start;
+    ChessGame other = load("8/8/8/4k3/8/8/3QK3/8 w - - 0 1");
+    CachedAIMove out;
+
+    // A search that ran to its own limits
+    auto searched = [](Move move, int score) {
+        return ChessAIMoveResult{move, 0, 0, false, 3, false, score, false};
+    };
+
+    cache->store(start.getHash(), "medium", 3, searched(start.resolveMove(Move::fromString("e2e4")), 25));
+    check(cache->lookup(start, "medium", 3, out) && out.move.toString() == "e2e4" && out.score == 25,
+          "a legal cached move is served");
+    check(!cache->lookup(start, "hard", 3, out) && !cache->lookup(start, "medium", 4, out),
+          "difficulty and depth are part of the key");
+
+    // As after a key collision: a move from another position under this key
+    cache->store(other.getHash(), "medium", 3, searched(start.resolveMove(Move::fromString("g1f3")), 10));
+    check(!cache->lookup(other, "medium", 3, out), "an illegal cached move is not served");
+
+    cache->store(start.getHash(), "easy", 3, searched(Move::fromString("e2e5"), 0));
+    check(!cache->lookup(start, "easy", 3, out), "a cached move the rules reject is not served");
+
+    // Results whose depth or move depend on timing or chance are not kept
+    ChessAIMoveResult stopped = searched(start.resolveMove(Move::fromString("d2d4")), 30);
+    stopped.stopped = true;
+    ChessAIMoveResult partial = searched(start.resolveMove(Move::fromString("d2d4")), 30);
+    partial.depth_reached = 0;
+    ChessAIMoveResult book = searched(start.resolveMove(Move::fromString("d2d4")), 0);
+    book.from_book = true;
+    bool stored = cache->store(start.getHash(), "hard", 3, stopped) ||
+                  cache->store(start.getHash(), "hard", 3, partial) ||
+                  cache->store(start.getHash(), "hard", 3, book);
+    check(!stored && !cache->lookup(start, "hard", 3, out), "stopped, partial and book results are not cached");
+
+    // A search cancelled through its stop flag says so
+    std::atomic<bool> stop(true);
+    TranspositionTable tt(1);
+    ChessAI ai(4);
+    ai.set_transposition_table(&tt);
+    ai.set_stop_flag(&stop);
+    ChessAIMoveResult cancelled = ai.make_move(start, true);
+    check(cancelled.stopped && !cancelled.timed_out && !cancelled.move.isNull(),
+          "a search cut short by its stop flag is marked stopped");
+    check(!cache->store(start.getHash(), "hard", 4, cancelled) && !cache->lookup(start, "hard", 4, out),
+          "a stopped search is not cached");
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "=== AI Tests ===" << std::endl;
+    testMates();
+    testDraws();
+    testBitbase();
+    testBook();
+    testResultCache();
+
+    std::cout << std::endl << (failures == 0 ? "All AI tests passed" : "AI tests FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
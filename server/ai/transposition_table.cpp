@@ -0,0 +1,81 @@
+#include "transposition_table.h"
+
+TranspositionTable::TranspositionTable(size_t size_mb) : bucket_count(0), generation(0) {
+    resize(size_mb);
+}
+
+void TranspositionTable::resize(size_t size_mb) {
+    size_t count = (size_mb << 20) / sizeof(Bucket);
+    if (count == 0) count = 1;
+
+    buckets.reset(new Bucket[count]);
+    bucket_count = count;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucket_count; i++) {
+        for (Entry& e : buckets[i].entries) {
+            e.key_xor_data.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_search() {
+    const uint8_t next = (generation.load(std::memory_order_relaxed) + 1) & ((1 << GENERATION_BITS) - 1);
+    generation.store(next, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTHit& out) const {
+    const Bucket& bucket = bucket_for(key);
+    for (const Entry& e : bucket.entries) {
+        uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor_data.load(std::memory_order_relaxed) ^ data) != key) continue;
+        if (bound_of(data) == BOUND_NONE) continue;
+
+        out.move = Move::fromRaw(static_cast<uint16_t>(data));
+        out.score = static_cast<int32_t>(static_cast<uint32_t>(data >> 16));
+        out.depth = depth_of(data);
+        out.bound = bound_of(data);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, TTBound bound) {
+    if (depth < 0) depth = 0;
+    if (depth > 255) depth = 255;
+
+    const uint8_t generation = this->generation.load(std::memory_order_relaxed);
+    Bucket& bucket = bucket_for(key);
+    Entry* victim = &bucket.entries[0];
+    int victim_value = 1 << 30;
+
+    for (Entry& e : bucket.entries) {
+        uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor_data.load(std::memory_order_relaxed) ^ data) == key) {
+            // Same position: keep a much deeper result from this search,
+            // but never lose its best move to a store without one
+            if (bound != BOUND_EXACT && generation_of(data) == generation && depth_of(data) > depth + 2) {
+                return;
+            }
+            if (move.isNull()) move = Move::fromRaw(static_cast<uint16_t>(data));
+            victim = &e;
+            break;
+        }
+
+        // Older generations count as shallower so stale entries go first
+        int age = (generation - generation_of(data)) & ((1 << GENERATION_BITS) - 1);
+        int value = (bound_of(data) == BOUND_NONE) ? -1000 : depth_of(data) - 8 * age;
+        if (value < victim_value) {
+            victim_value = value;
+            victim = &e;
+        }
+    }
+
+    uint64_t data = pack(move, score, depth, bound, generation);
+    victim->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
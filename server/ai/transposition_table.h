@@ -0,0 +1,89 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "../game/chess_game.cpp"
+
+// Which side of the search window a stored score lies on
+enum TTBound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,  // failed low: true score <= stored score
+    BOUND_LOWER = 2,  // failed high: true score >= stored score
+    BOUND_EXACT = 3
+};
+
+struct TTHit {
+    Move move;
+    int score;
+    int depth;
+    TTBound bound;
+};
+
+// Fixed-size hash of search results keyed by the Zobrist key.
+//
+// Entries live in 64-byte buckets (one cache line, four entries), so a probe
+// touches a single line. Each entry stores the key XOR-ed with its data; a
+// write torn by another thread then fails the key check and reads as a miss,
+// which lets several search threads share one table without locking.
+//
+// Replacement: an entry for the same position is overwritten unless the old
+// one is much deeper; otherwise the entry with the lowest depth, counting
+// entries from older searches as shallower, is evicted.
+class TranspositionTable {
+public:
+    static constexpr size_t DEFAULT_SIZE_MB = 4;
+
+    explicit TranspositionTable(size_t size_mb = DEFAULT_SIZE_MB);
+
+    // Reallocate to the given budget (at least one bucket); drops all entries
+    void resize(size_t size_mb);
+    void clear();
+
+    // Start a new search; entries from earlier searches become replaceable
+    void new_search();
+
+    bool probe(uint64_t key, TTHit& out) const;
+    void store(uint64_t key, Move move, int score, int depth, TTBound bound);
+
+    size_t size_mb() const { return (bucket_count * sizeof(Bucket)) >> 20; }
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+    static constexpr int GENERATION_BITS = 6;
+
+    struct Entry {
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucket_count;
+    std::atomic<uint8_t> generation;  // read by every search thread, bumped by new_search()
+
+    Bucket& bucket_for(uint64_t key) const {
+        // Multiply-shift maps the key onto any bucket count without a modulo
+        return buckets[static_cast<size_t>((static_cast<unsigned __int128>(key) * bucket_count) >> 64)];
+    }
+
+    // data layout: move (16) | score (32) | depth (8) | bound (2) | generation (6)
+    static uint64_t pack(Move move, int score, int depth, TTBound bound, uint8_t generation) {
+        return static_cast<uint64_t>(move.raw()) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(score)) << 16) |
+               (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48) |
+               (static_cast<uint64_t>(bound) << 56) |
+               (static_cast<uint64_t>(generation) << 58);
+    }
+    static int depth_of(uint64_t data) { return static_cast<int>((data >> 48) & 0xFF); }
+    static TTBound bound_of(uint64_t data) { return static_cast<TTBound>((data >> 56) & 3); }
+    static uint8_t generation_of(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -0,0 +1,227 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+// Precomputed attack sets for every piece type.
+//
+// Leaper (knight, king, pawn) tables are filled once per square. Slider
+// (rook, bishop) attacks use magic bitboards: the relevant blocker bits are
+// multiplied by a per-square magic number and the top bits index a shared
+// table. When the compiler targets BMI2 (-mbmi2 or -march=native) the PEXT
+// instruction computes the index directly and no magic search is needed.
+
+struct SliderMagic {
+    Bitboard mask;      // relevant blocker squares (board edges excluded)
+    Bitboard magic;
+    unsigned shift;
+    Bitboard* attacks;  // slice of the shared table for this square
+
+    unsigned index(Bitboard occupied) const {
+#ifdef __BMI2__
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+class AttackTables {
+public:
+    Bitboard knight[64];
+    Bitboard king[64];
+    Bitboard pawn[2][64];  // [Color][square]: squares a pawn of that color attacks
+    Bitboard between[64][64];  // squares strictly between two aligned squares, else 0
+    Bitboard line[64][64];     // full board line through two aligned squares, else 0
+
+    SliderMagic rook_magics[64];
+    SliderMagic bishop_magics[64];
+
+    AttackTables() : rook_table(ROOK_TABLE_SIZE), bishop_table(BISHOP_TABLE_SIZE) {
+        static const int knight_steps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2},
+                                               {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        static const int king_steps[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1},
+                                             {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+        for (int sq = 0; sq < 64; sq++) {
+            knight[sq] = 0;
+            king[sq] = 0;
+            for (int i = 0; i < 8; i++) {
+                knight[sq] |= offsetSquare(sq, knight_steps[i][0], knight_steps[i][1]);
+                king[sq] |= offsetSquare(sq, king_steps[i][0], king_steps[i][1]);
+            }
+            pawn[0][sq] = offsetSquare(sq, -1, 1) | offsetSquare(sq, 1, 1);
+            pawn[1][sq] = offsetSquare(sq, -1, -1) | offsetSquare(sq, 1, -1);
+        }
+
+        static const int rook_dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        static const int bishop_dirs[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        initSliders(rook_magics, rook_table.data(), rook_dirs);
+        initSliders(bishop_magics, bishop_table.data(), bishop_dirs);
+
+        for (int a = 0; a < 64; a++) {
+            for (int b = 0; b < 64; b++) {
+                between[a][b] = 0;
+                line[a][b] = 0;
+                if (a == b) continue;
+
+                const int (*dirs)[2] = nullptr;
+                if (slidingAttacks(a, 0, rook_dirs) & squareBB(b)) dirs = rook_dirs;
+                else if (slidingAttacks(a, 0, bishop_dirs) & squareBB(b)) dirs = bishop_dirs;
+                if (!dirs) continue;
+
+                Bitboard from_a = slidingAttacks(a, squareBB(b), dirs);
+                Bitboard from_b = slidingAttacks(b, squareBB(a), dirs);
+                between[a][b] = from_a & from_b;
+                line[a][b] = (slidingAttacks(a, 0, dirs) & slidingAttacks(b, 0, dirs)) |
+                             squareBB(a) | squareBB(b);
+            }
+        }
+    }
+
+private:
+    static constexpr int ROOK_TABLE_SIZE = 0x19000;
+    static constexpr int BISHOP_TABLE_SIZE = 0x1480;
+
+    std::vector<Bitboard> rook_table;
+    std::vector<Bitboard> bishop_table;
+
+    static Bitboard offsetSquare(int sq, int file_step, int rank_step) {
+        int file = fileOf(sq) + file_step;
+        int rank = rankOf(sq) + rank_step;
+        if (file < 0 || file > 7 || rank < 0 || rank > 7) return 0;
+        return squareBB(makeSquare(file, rank));
+    }
+
+    // Ray walk used only while building the tables
+    static Bitboard slidingAttacks(int sq, Bitboard occupied, const int dirs[4][2]) {
+        Bitboard attacks = 0;
+        for (int d = 0; d < 4; d++) {
+            int file = fileOf(sq) + dirs[d][0];
+            int rank = rankOf(sq) + dirs[d][1];
+            while (file >= 0 && file <= 7 && rank >= 0 && rank <= 7) {
+                Bitboard b = squareBB(makeSquare(file, rank));
+                attacks |= b;
+                if (occupied & b) break;
+                file += dirs[d][0];
+                rank += dirs[d][1];
+            }
+        }
+        return attacks;
+    }
+
+    // Deterministic xorshift64* so every process builds identical magics
+    static uint64_t nextRandom(uint64_t& state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    void initSliders(SliderMagic* magics, Bitboard* table, const int dirs[4][2]) {
+        Bitboard occupancy[4096];
+        Bitboard reference[4096];
+        int epoch[4096] = {0};
+        int attempt = 0;
+
+        // Per-rank seeds known to converge quickly with this generator
+        static const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+        Bitboard* next_slice = table;
+        for (int sq = 0; sq < 64; sq++) {
+            Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~(RANK_1_BB << (8 * rankOf(sq)))) |
+                             ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << fileOf(sq)));
+
+            SliderMagic& m = magics[sq];
+            m.mask = slidingAttacks(sq, 0, dirs) & ~edges;
+            m.shift = 64 - popCount(m.mask);
+            m.magic = 0;
+            m.attacks = next_slice;
+
+            // Enumerate every blocker subset of the mask (Carry-Rippler)
+            int size = 0;
+            Bitboard subset = 0;
+            do {
+                occupancy[size] = subset;
+                reference[size] = slidingAttacks(sq, subset, dirs);
+                size++;
+                subset = (subset - m.mask) & m.mask;
+            } while (subset);
+            next_slice += size;
+
+#ifdef __BMI2__
+            for (int i = 0; i < size; i++) {
+                m.attacks[m.index(occupancy[i])] = reference[i];
+            }
+#else
+            // Search for a magic that maps every subset without destructive collisions
+            uint64_t seed = seeds[rankOf(sq)];
+            bool found = false;
+            while (!found) {
+                do {
+                    m.magic = nextRandom(seed) & nextRandom(seed) & nextRandom(seed);
+                } while (popCount((m.mask * m.magic) >> 56) < 6);
+
+                attempt++;
+                found = true;
+                for (int i = 0; i < size; i++) {
+                    unsigned idx = m.index(occupancy[i]);
+                    if (epoch[idx] < attempt) {
+                        epoch[idx] = attempt;
+                        m.attacks[idx] = reference[i];
+                    } else if (m.attacks[idx] != reference[i]) {
+                        found = false;
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+};
+
+// Built once during static initialization and shared read-only by every thread.
+inline const AttackTables attackTables;
+
+inline Bitboard knightAttacks(int sq) {
+    return attackTables.knight[sq];
+}
+
+inline Bitboard kingAttacks(int sq) {
+    return attackTables.king[sq];
+}
+
+inline Bitboard pawnAttacks(int color, int sq) {
+    return attackTables.pawn[color][sq];
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    const SliderMagic& m = attackTables.rook_magics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    const SliderMagic& m = attackTables.bishop_magics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+inline Bitboard betweenBB(int a, int b) {
+    return attackTables.between[a][b];
+}
+
+inline Bitboard lineBB(int a, int b) {
+    return attackTables.line[a][b];
+}
+
+#endif // ATTACKS_H
@@ -0,0 +1,49 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+// 64-bit square sets used by the chess engine.
+// Squares are indexed a1 = 0, b1 = 1, ..., h1 = 7, a2 = 8, ..., h8 = 63.
+typedef uint64_t Bitboard;
+
+constexpr int NO_SQUARE = -1;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+constexpr Bitboard squareBB(int sq) {
+    return 1ULL << sq;
+}
+
+constexpr int makeSquare(int file, int rank) {
+    return rank * 8 + file;
+}
+
+constexpr int fileOf(int sq) {
+    return sq & 7;
+}
+
+constexpr int rankOf(int sq) {
+    return sq >> 3;
+}
+
+inline int popCount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+// Index of the least significant set bit. b must be non-zero.
+inline int lsb(Bitboard b) {
+    return __builtin_ctzll(b);
+}
+
+// Returns the least significant set bit and clears it from b.
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+#endif // BITBOARD_H
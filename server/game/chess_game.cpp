@@ -6,6 +6,16 @@
 #include <string>
 #include <cctype>
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <sstream>
+#include <optional>
+
+#include "bitboard.h"
+#include "attacks.h"
+#include "zobrist.h"
+#include "psqt.h"
 
 using namespace std;
 
@@ -19,6 +29,11 @@ enum PieceType {
     NONE
 };
 
+enum Color {
+    WHITE,
+    BLACK
+};
+
 enum GameResult {
     ONGOING,
     WHITE_WIN,
@@ -26,57 +41,252 @@ enum GameResult {
     DRAW
 };
 
+// Why checkGameEnd() ended the game
+enum GameEndReason {
+    END_NONE,
+    END_CHECKMATE,
+    END_STALEMATE,
+    END_FIFTY_MOVE_RULE
+};
+
+// Castling right bits stored in Position::castling
+enum CastlingRight {
+    WHITE_OO = 1,
+    WHITE_OOO = 2,
+    BLACK_OO = 4,
+    BLACK_OOO = 8,
+    ALL_CASTLING = 15
+};
+
+// Flat board state: one bitboard per (color, piece) plus occupancy.
+// Trivially copyable, so the engine can copy positions with a plain memcpy.
+struct Position {
+    Bitboard pieces[2][6];  // [Color][PieceType]
+    Bitboard occupied[2];   // all pieces of one color
+    Bitboard all;           // occupied[WHITE] | occupied[BLACK]
+    uint8_t side_to_move;   // Color
+    uint8_t castling;       // CastlingRight bits
+    int8_t ep_square;       // square a pawn can capture onto en passant, or NO_SQUARE
+    uint16_t halfmove_clock; // plies since the last capture or pawn move
+    uint64_t key;           // Zobrist hash, kept in sync by putPiece/removePiece and applyMove
+    uint64_t pawn_key;      // Zobrist hash of the pawns alone (pawn-structure cache)
+    int32_t psq_mg;         // material + piece-square sums (white minus black), kept by putPiece/removePiece
+    int32_t psq_eg;
+    int32_t phase;          // sum of phaseWeight over the board; PHASE_MAX at the start
+
+    void clear() {
+        for (int c = 0; c < 2; c++) {
+            for (int p = 0; p < 6; p++) pieces[c][p] = 0;
+            occupied[c] = 0;
+        }
+        all = 0;
+        side_to_move = WHITE;
+        castling = 0;
+        ep_square = NO_SQUARE;
+        halfmove_clock = 0;
+        key = 0;
+        pawn_key = 0;
+        psq_mg = 0;
+        psq_eg = 0;
+        phase = 0;
+    }
+
+    // Full Zobrist hash computed from scratch (setup and consistency checks)
+    uint64_t computeKey() const {
+        uint64_t k = 0;
+        for (int c = 0; c < 2; c++) {
+            for (int p = 0; p < 6; p++) {
+                Bitboard b = pieces[c][p];
+                while (b) k ^= zobrist.piece[c][p][popLsb(b)];
+            }
+        }
+        k ^= zobrist.castling[castling];
+        if (ep_square != NO_SQUARE) k ^= zobrist.ep_file[fileOf(ep_square)];
+        if (side_to_move == BLACK) k ^= zobrist.black_to_move;
+        return k;
+    }
+
+    PieceType pieceAt(int sq) const {
+        Bitboard b = squareBB(sq);
+        if (!(all & b)) return NONE;
+        int color = (occupied[WHITE] & b) ? WHITE : BLACK;
+        for (int p = KING; p <= PAWN; p++) {
+            if (pieces[color][p] & b) return static_cast<PieceType>(p);
+        }
+        return NONE;
+    }
+
+    bool isWhiteAt(int sq) const {
+        return (occupied[WHITE] & squareBB(sq)) != 0;
+    }
+
+    void putPiece(PieceType piece, int color, int sq) {
+        Bitboard b = squareBB(sq);
+        pieces[color][piece] |= b;
+        occupied[color] |= b;
+        all |= b;
+        key ^= zobrist.piece[color][piece][sq];
+        if (piece == PAWN) pawn_key ^= zobrist.piece[color][PAWN][sq];
+        psq_mg += psqt.mg[color][piece][sq];
+        psq_eg += psqt.eg[color][piece][sq];
+        phase += phaseWeight[piece];
+    }
+
+    void removePiece(PieceType piece, int color, int sq) {
+        Bitboard b = ~squareBB(sq);
+        pieces[color][piece] &= b;
+        occupied[color] &= b;
+        all &= b;
+        key ^= zobrist.piece[color][piece][sq];
+        if (piece == PAWN) pawn_key ^= zobrist.piece[color][PAWN][sq];
+        psq_mg -= psqt.mg[color][piece][sq];
+        psq_eg -= psqt.eg[color][piece][sq];
+        phase -= phaseWeight[piece];
+    }
+
+    int kingSquare(int color) const {
+        Bitboard b = pieces[color][KING];
+        return b ? lsb(b) : NO_SQUARE;
+    }
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must stay trivially copyable");
+
+// Compact 16-bit move encoding:
+//   bits 0-5    from square
+//   bits 6-11   to square
+//   bits 12-13  promotion piece (0 = queen, 1 = rook, 2 = bishop, 3 = knight)
+//   bits 14-15  kind (normal, promotion, en passant, castling)
+// The all-zero value (a1a1) is the null move.
+class Move {
+public:
+    enum Kind {
+        NORMAL = 0,
+        PROMOTION = 1,
+        EN_PASSANT = 2,
+        CASTLING = 3
+    };
+
+    Move() : data(0) {}
+
+    Move(int from, int to, Kind kind = NORMAL, PieceType promotion = QUEEN)
+        : data(static_cast<uint16_t>(from | (to << 6) | ((promotion - QUEEN) << 12) | (kind << 14))) {}
+
+    int from() const { return data & 0x3F; }
+    int to() const { return (data >> 6) & 0x3F; }
+    Kind kind() const { return static_cast<Kind>(data >> 14); }
+    PieceType promotion() const { return static_cast<PieceType>(QUEEN + ((data >> 12) & 3)); }
+
+    bool isNull() const { return data == 0; }
+    uint16_t raw() const { return data; }
+    static Move fromRaw(uint16_t raw) { Move m; m.data = raw; return m; }
+
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+
+    // Coordinate notation, e.g. "e2e4" or "e7e8q"
+    string toString() const {
+        static const char promotionSuffix[] = "qrbn";
+        string s;
+        s += char('a' + fileOf(from()));
+        s += char('1' + rankOf(from()));
+        s += char('a' + fileOf(to()));
+        s += char('1' + rankOf(to()));
+        if (kind() == PROMOTION) s += promotionSuffix[promotion() - QUEEN];
+        return s;
+    }
+
+    // Parse coordinate notation from a client. Only the squares and the
+    // promotion suffix are known here; ChessGame fills in the real kind when
+    // it matches the request against its legal moves. Returns the null move
+    // if the text is malformed.
+    static Move fromString(const string& text) {
+        // Expected format: "e2e4" (from position to position) or "e7e8q" (with promotion)
+        if (text.length() != 4 && text.length() != 5) return Move();
+
+        int from, to;
+        if (!parseSquare(text, 0, from) || !parseSquare(text, 2, to) || from == to) return Move();
+
+        if (text.length() == 4) return Move(from, to);
+
+        PieceType promotion;
+        switch (tolower(text[4])) {
+            case 'q': promotion = QUEEN; break;
+            case 'r': promotion = ROOK; break;
+            case 'b': promotion = BISHOP; break;
+            case 'n': promotion = KNIGHT; break;
+            default: return Move();
+        }
+        return Move(from, to, PROMOTION, promotion);
+    }
+
+private:
+    uint16_t data;
+
+    // Helper function to parse chess notation (e.g., "e2" -> square 12)
+    static bool parseSquare(const string& text, size_t offset, int& sq) {
+        int file = tolower(text[offset]) - 'a';
+        int rank = text[offset + 1] - '1';
+        if (file < 0 || file >= 8 || rank < 0 || rank >= 8) return false;
+
+        sq = makeSquare(file, rank);
+        return true;
+    }
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay 16 bits");
+
+// Fixed-capacity move buffer that lives on the caller's stack.
+// 256 is above the maximum number of legal moves in any reachable position.
+struct MoveList {
+    static constexpr int MAX_MOVES = 256;
+
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void add(Move m) { moves[count++] = m; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Compact game-log entry; turned into descriptive text only when the log is read
+struct MoveRecord {
+    Move move;
+    uint8_t piece;     // PieceType that moved (PAWN for promotions)
+    uint8_t captured;  // PieceType, NONE if nothing was captured
+};
+
+// State destroyed by makeMove() that unmakeMove() cannot recompute
+struct UndoInfo {
+    uint64_t key;             // Zobrist hash before the move, also used for repetition checks
+    Move move;
+    uint8_t captured;         // PieceType, NONE if nothing was captured
+    uint8_t castling;
+    int8_t ep_square;
+    uint16_t halfmove_clock;
+};
+
 class ChessGame {
-private: 
-    vector<vector<PieceType>> board;
-    vector<vector<bool>> is_white; // true if piece is white, false if black
-    vector<string> move_history; // Game log with descriptive moves
+private:
+    Position pos;
+    vector<UndoInfo> undo_stack; // One entry per move made, newest last
+    vector<MoveRecord> move_history; // Game log, rendered by getGameLog()
     int turn;
     bool is_ended;
     GameResult result;
-    
-    // Castling rights
-    bool white_king_moved;
-    bool white_rook_a_moved;
-    bool white_rook_h_moved;
-    bool black_king_moved;
-    bool black_rook_a_moved;
-    bool black_rook_h_moved;
-    
-    // Helper function to parse chess notation (e.g., "e2" -> row=6, col=4)
-    bool parsePosition(const string& pos, int& row, int& col) {
-        if (pos.length() != 2) return false;
-        
-        col = tolower(pos[0]) - 'a';
-        row = 8 - (pos[1] - '0');
-        
-        return (col >= 0 && col < 8 && row >= 0 && row < 8);
-    }
+    GameEndReason end_reason;
+
+    // Bumped on every position change; never reused, so equal versions mean
+    // an unchanged position
+    uint64_t version;
+    mutable string fen_cache;
+    mutable uint64_t fen_cache_version; // 0 = nothing cached
 
-    // Parse promotion character to piece type (q=Queen, r=Rook, b=Bishop, n=Knight)
-    bool parsePromotion(char promotionChar, PieceType &promotionPiece)
-    {
-        switch (tolower(promotionChar))
-        {
-        case 'q':
-            promotionPiece = QUEEN;
-            return true;
-        case 'r':
-            promotionPiece = ROOK;
-            return true;
-        case 'b':
-            promotionPiece = BISHOP;
-            return true;
-        case 'n':
-            promotionPiece = KNIGHT;
-            return true;
-        default:
-            return false;
-        }
-    }
-    
     // Convert piece type to string
-    string pieceToString(PieceType piece) {
+    static string pieceToString(PieceType piece) {
         switch (piece) {
             case KING: return "King";
             case QUEEN: return "Queen";
@@ -87,427 +297,570 @@ private:
             default: return "Unknown";
         }
     }
-    
-    // Convert position to chess notation
-    string positionToNotation(int row, int col) {
+
+    // Convert square to chess notation
+    static string positionToNotation(int sq) {
         string notation;
-        notation += char('a' + col);
-        notation += char('8' - row);
+        notation += char('a' + fileOf(sq));
+        notation += char('1' + rankOf(sq));
         return notation;
     }
-    
-    // Generate descriptive log entry
-    string generateLogEntry(int fromRow, int fromCol, int toRow, int toCol, bool isCapture, bool isCastling, PieceType promotionPiece = NONE)
+
+    // Generate descriptive log entry for the move played at the given turn
+    string generateLogEntry(const MoveRecord& record, int moveTurn) const
     {
         string log;
-        string playerColor = (turn % 2 == 0) ? "White" : "Black";
-        int moveNumber = (turn / 2) + 1;
-        
+        string playerColor = (moveTurn % 2 == 0) ? "White" : "Black";
+        int moveNumber = (moveTurn / 2) + 1;
+
         log += to_string(moveNumber) + ". " + playerColor + " - ";
-        
-        if (isCastling) {
-            bool isKingside = (toCol > fromCol);
+
+        Move m = record.move;
+        if (m.kind() == Move::CASTLING) {
+            bool isKingside = (m.to() > m.from());
             log += isKingside ? "Castles kingside (O-O)" : "Castles queenside (O-O-O)";
         } else {
-            PieceType piece = board[fromRow][fromCol];
-            log += pieceToString(piece);
-            log += " from " + positionToNotation(fromRow, fromCol);
-            log += " to " + positionToNotation(toRow, toCol);
-            
-            if (isCapture) {
-                log += " (captures " + pieceToString(board[toRow][toCol]) + ")";
+            log += pieceToString(static_cast<PieceType>(record.piece));
+            log += " from " + positionToNotation(m.from());
+            log += " to " + positionToNotation(m.to());
+
+            if (record.captured != NONE) {
+                log += " (captures " + pieceToString(static_cast<PieceType>(record.captured)) + ")";
             }
 
-            if (promotionPiece != NONE)
+            if (m.kind() == Move::PROMOTION)
             {
-                log += " promotes to " + pieceToString(promotionPiece);
+                log += " promotes to " + pieceToString(m.promotion());
             }
         }
-        
+
         return log;
     }
-    
-    // Check if a position is valid
-    bool isValidPosition(int row, int col) {
-        return row >= 0 && row < 8 && col >= 0 && col < 8;
+
+    // Check if a square is attacked by the given side in position p
+    bool isSquareUnderAttack(const Position& p, int sq, bool byWhite) const {
+        int attacker = byWhite ? WHITE : BLACK;
+        const Bitboard* theirs = p.pieces[attacker];
+
+        // A pawn attacks sq exactly when a pawn of the other color on sq would attack it back
+        return (pawnAttacks(attacker ^ 1, sq) & theirs[PAWN]) ||
+               (knightAttacks(sq) & theirs[KNIGHT]) ||
+               (kingAttacks(sq) & theirs[KING]) ||
+               (bishopAttacks(sq, p.all) & (theirs[BISHOP] | theirs[QUEEN])) ||
+               (rookAttacks(sq, p.all) & (theirs[ROOK] | theirs[QUEEN]));
     }
-    
-    // Check if king is under attack (for castling validation)
-    bool isSquareUnderAttack(int row, int col, bool byWhite) {
-        // Check all opponent pieces to see if they can attack this square
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                if (board[i][j] != NONE && is_white[i][j] == byWhite) {
-                    // For pawns, check diagonal attacks only
-                    if (board[i][j] == PAWN) {
-                        int direction = byWhite ? -1 : 1;
-                        if (row == i + direction && abs(col - j) == 1) {
-                            return true;
-                        }
-                    } else if (isValidPieceMove(board[i][j], i, j, row, col, byWhite)) {
-                        return true;
-                    }
-                }
+
+    // All pieces of either color attacking sq, given an occupancy (used with the king lifted off the board)
+    Bitboard attackersTo(const Position& p, int sq, Bitboard occupied) const {
+        return (pawnAttacks(WHITE, sq) & p.pieces[BLACK][PAWN]) |
+               (pawnAttacks(BLACK, sq) & p.pieces[WHITE][PAWN]) |
+               (knightAttacks(sq) & (p.pieces[WHITE][KNIGHT] | p.pieces[BLACK][KNIGHT])) |
+               (kingAttacks(sq) & (p.pieces[WHITE][KING] | p.pieces[BLACK][KING])) |
+               (bishopAttacks(sq, occupied) & (p.pieces[WHITE][BISHOP] | p.pieces[BLACK][BISHOP] |
+                                               p.pieces[WHITE][QUEEN] | p.pieces[BLACK][QUEEN])) |
+               (rookAttacks(sq, occupied) & (p.pieces[WHITE][ROOK] | p.pieces[BLACK][ROOK] |
+                                             p.pieces[WHITE][QUEEN] | p.pieces[BLACK][QUEEN]));
+    }
+
+    // Own pieces that are the only blocker between our king and an enemy slider
+    Bitboard pinnedPieces(const Position& p, int us, int kingSq) const {
+        int them = us ^ 1;
+        const Bitboard* theirs = p.pieces[them];
+        Bitboard snipers = (rookAttacks(kingSq, 0) & (theirs[ROOK] | theirs[QUEEN])) |
+                           (bishopAttacks(kingSq, 0) & (theirs[BISHOP] | theirs[QUEEN]));
+
+        Bitboard pinned = 0;
+        while (snipers) {
+            int sniper = popLsb(snipers);
+            Bitboard blockers = betweenBB(kingSq, sniper) & p.all;
+            if (blockers && !(blockers & (blockers - 1)) && (blockers & p.occupied[us])) {
+                pinned |= blockers;
             }
         }
-        return false;
+        return pinned;
     }
-    
-    // Check if castling is valid
-    bool canCastle(int fromRow, int fromCol, int toRow, int toCol, bool isWhite) {
-        // Must be king moving two squares horizontally on back rank
-        if (board[fromRow][fromCol] != KING) return false;
-        if (fromRow != toRow) return false;
-        if (abs(toCol - fromCol) != 2) return false;
-        
-        int expectedRow = isWhite ? 7 : 0;
-        if (fromRow != expectedRow) return false;
-        
-        // Check if king has moved
-        if (isWhite && white_king_moved) return false;
-        if (!isWhite && black_king_moved) return false;
-        
-        // Determine if kingside or queenside castling
-        bool isKingside = (toCol > fromCol);
-        int rookCol = isKingside ? 7 : 0;
-        
-        // Check if rook has moved
-        if (isWhite) {
-            if (isKingside && white_rook_h_moved) return false;
-            if (!isKingside && white_rook_a_moved) return false;
-        } else {
-            if (isKingside && black_rook_h_moved) return false;
-            if (!isKingside && black_rook_a_moved) return false;
-        }
-        
-        // Check if rook is still in place
-        if (board[expectedRow][rookCol] != ROOK) return false;
-        if (is_white[expectedRow][rookCol] != isWhite) return false;
-        
-        // Check if squares between king and rook are empty
-        int startCol = min(fromCol, rookCol);
-        int endCol = max(fromCol, rookCol);
-        for (int col = startCol + 1; col < endCol; col++) {
-            if (board[expectedRow][col] != NONE) return false;
+
+    void addPawnMoves(MoveList& list, int from, Bitboard targets, int us) const {
+        Bitboard promotionRank = (us == WHITE) ? RANK_8_BB : RANK_1_BB;
+        while (targets) {
+            int to = popLsb(targets);
+            if (squareBB(to) & promotionRank) {
+                list.add(Move(from, to, Move::PROMOTION, QUEEN));
+                list.add(Move(from, to, Move::PROMOTION, ROOK));
+                list.add(Move(from, to, Move::PROMOTION, BISHOP));
+                list.add(Move(from, to, Move::PROMOTION, KNIGHT));
+            } else {
+                list.add(Move(from, to));
+            }
         }
-        
-        // Check if king is in check
-        if (isSquareUnderAttack(fromRow, fromCol, !isWhite)) return false;
-        
-        // Check if king passes through or lands on a square under attack
+    }
+
+    void addCastling(const Position& p, MoveList& list, int us, int kingSq, bool isKingside) const {
+        int backRank = (us == WHITE) ? 0 : 7;
+        int right = (us == WHITE) ? (isKingside ? WHITE_OO : WHITE_OOO)
+                                  : (isKingside ? BLACK_OO : BLACK_OOO);
+        if (!(p.castling & right) || kingSq != makeSquare(4, backRank)) return;
+
+        int rookSq = makeSquare(isKingside ? 7 : 0, backRank);
+        if (!(p.pieces[us][ROOK] & squareBB(rookSq))) return;
+        if (betweenBB(kingSq, rookSq) & p.all) return;
+
+        // The king may not pass through or land on an attacked square
         int direction = isKingside ? 1 : -1;
-        for (int col = fromCol; col != toCol + direction; col += direction) {
-            if (isSquareUnderAttack(expectedRow, col, !isWhite)) return false;
+        for (int sq = kingSq + direction; sq != kingSq + 3 * direction; sq += direction) {
+            if (isSquareUnderAttack(p, sq, us == BLACK)) return;
         }
-        
-        return true;
+        list.add(Move(kingSq, kingSq + 2 * direction, Move::CASTLING));
     }
-    
-    // Check if path is clear for sliding pieces (rook, bishop, queen)
-    bool isPathClear(int fromRow, int fromCol, int toRow, int toCol) {
-        int rowDir = (toRow > fromRow) ? 1 : (toRow < fromRow) ? -1 : 0;
-        int colDir = (toCol > fromCol) ? 1 : (toCol < fromCol) ? -1 : 0;
-        
-        int currRow = fromRow + rowDir;
-        int currCol = fromCol + colDir;
-        
-        while (currRow != toRow || currCol != toCol) {
-            if (board[currRow][currCol] != NONE) return false;
-            currRow += rowDir;
-            currCol += colDir;
+
+    // Legal move generator. Only piece-specific target squares are produced;
+    // check and pin masks filter them so no move has to be tried and undone.
+    void generateLegalMoves(const Position& p, int us, MoveList& list) const {
+        list.count = 0;
+
+        int them = us ^ 1;
+        int kingSq = p.kingSquare(us);
+        if (kingSq == NO_SQUARE) return;
+
+        Bitboard own = p.occupied[us];
+        Bitboard enemy = p.occupied[them];
+        Bitboard checkers = attackersTo(p, kingSq, p.all) & enemy;
+
+        // King moves, tested with the king lifted off so it cannot hide on a slider's ray
+        Bitboard withoutKing = p.all ^ squareBB(kingSq);
+        Bitboard kingTargets = kingAttacks(kingSq) & ~own;
+        while (kingTargets) {
+            int to = popLsb(kingTargets);
+            if (!(attackersTo(p, to, withoutKing) & enemy)) list.add(Move(kingSq, to));
         }
-        
-        return true;
-    }
-    
-    // Validate move for specific piece type
-    bool isValidPieceMove(PieceType piece, int fromRow, int fromCol, int toRow, int toCol, bool isWhite) {
-        int rowDiff = toRow - fromRow;
-        int colDiff = toCol - fromCol;
-        
-        switch (piece) {
-            case PAWN: {
-                int direction = isWhite ? -1 : 1; // white moves up, black moves down
-                int startRow = isWhite ? 6 : 1;
-                
-                // Forward move
-                if (colDiff == 0) {
-                    if (rowDiff == direction && board[toRow][toCol] == NONE) return true;
-                    if (fromRow == startRow && rowDiff == 2 * direction && 
-                        board[toRow][toCol] == NONE && 
-                        board[fromRow + direction][fromCol] == NONE) return true;
+
+        // Double check: only the king can move
+        if (checkers & (checkers - 1)) return;
+
+        // In check, other pieces must capture the checker or block
+        Bitboard checkMask = checkers ? (betweenBB(kingSq, lsb(checkers)) | checkers) : ~0ULL;
+        Bitboard pinned = pinnedPieces(p, us, kingSq);
+
+        for (int piece = QUEEN; piece <= KNIGHT; piece++) {
+            Bitboard pieces = p.pieces[us][piece];
+            while (pieces) {
+                int from = popLsb(pieces);
+                Bitboard targets;
+                switch (piece) {
+                    case QUEEN:  targets = queenAttacks(from, p.all); break;
+                    case ROOK:   targets = rookAttacks(from, p.all); break;
+                    case BISHOP: targets = bishopAttacks(from, p.all); break;
+                    default:     targets = knightAttacks(from); break;
                 }
-                // Capture
-                else if (abs(colDiff) == 1 && rowDiff == direction) {
-                    if (board[toRow][toCol] != NONE && is_white[toRow][toCol] != isWhite) 
-                        return true;
+                targets &= ~own & checkMask;
+                if (pinned & squareBB(from)) targets &= lineBB(kingSq, from);
+                while (targets) {
+                    list.add(Move(from, popLsb(targets)));
                 }
-                return false;
             }
-            
-            case KNIGHT:
-                return (abs(rowDiff) == 2 && abs(colDiff) == 1) || 
-                       (abs(rowDiff) == 1 && abs(colDiff) == 2);
-            
-            case BISHOP:
-                return abs(rowDiff) == abs(colDiff) && isPathClear(fromRow, fromCol, toRow, toCol);
-            
-            case ROOK:
-                return (rowDiff == 0 || colDiff == 0) && isPathClear(fromRow, fromCol, toRow, toCol);
-            
-            case QUEEN:
-                return ((rowDiff == 0 || colDiff == 0) || (abs(rowDiff) == abs(colDiff))) && 
-                       isPathClear(fromRow, fromCol, toRow, toCol);
-            
-            case KING:
-                return abs(rowDiff) <= 1 && abs(colDiff) <= 1;
-            
-            default:
-                return false;
+        }
+
+        int up = (us == WHITE) ? 8 : -8;
+        int startRank = (us == WHITE) ? 1 : 6;
+        Bitboard pawns = p.pieces[us][PAWN];
+        while (pawns) {
+            int from = popLsb(pawns);
+            Bitboard targets = pawnAttacks(us, from) & enemy;
+            if (!(p.all & squareBB(from + up))) {
+                targets |= squareBB(from + up);
+                if (rankOf(from) == startRank && !(p.all & squareBB(from + 2 * up))) {
+                    targets |= squareBB(from + 2 * up);
+                }
+            }
+            targets &= checkMask;
+            if (pinned & squareBB(from)) targets &= lineBB(kingSq, from);
+            addPawnMoves(list, from, targets, us);
+
+            // En passant is rare and can expose the king along the rank, so verify it directly
+            if (us == p.side_to_move && p.ep_square != NO_SQUARE &&
+                (pawnAttacks(us, from) & squareBB(p.ep_square))) {
+                Move m(from, p.ep_square, Move::EN_PASSANT);
+                Position next = p;
+                applyMove(next, m);
+                if (!isSquareUnderAttack(next, kingSq, them == WHITE)) list.add(m);
+            }
+        }
+
+        if (!checkers) {
+            addCastling(p, list, us, kingSq, true);
+            addCastling(p, list, us, kingSq, false);
         }
     }
-    
-public: 
+
+    // Castling rights lost when a piece leaves or arrives on a square
+    static uint8_t castlingRightsLost(int sq) {
+        switch (sq) {
+            case 0:  return WHITE_OOO;              // a1
+            case 4:  return WHITE_OO | WHITE_OOO;   // e1
+            case 7:  return WHITE_OO;               // h1
+            case 56: return BLACK_OOO;              // a8
+            case 60: return BLACK_OO | BLACK_OOO;   // e8
+            case 63: return BLACK_OO;               // h8
+            default: return 0;
+        }
+    }
+
+    // Play an already validated move on p (castling, en passant and promotion included).
+    // Returns the captured piece type, or NONE.
+    PieceType applyMove(Position& p, Move m) const {
+        int from = m.from();
+        int to = m.to();
+        int us = p.isWhiteAt(from) ? WHITE : BLACK;
+        int them = us ^ 1;
+        PieceType piece = p.pieceAt(from);
+        PieceType captured = p.pieceAt(to);
+
+        if (captured != NONE) {
+            p.removePiece(captured, them, to);
+        } else if (m.kind() == Move::EN_PASSANT) {
+            // En passant: the captured pawn sits behind the target square
+            captured = PAWN;
+            p.removePiece(PAWN, them, to + (us == WHITE ? -8 : 8));
+        }
+
+        p.removePiece(piece, us, from);
+        p.putPiece(m.kind() == Move::PROMOTION ? m.promotion() : piece, us, to);
+
+        // Castling: move the rook as well
+        if (m.kind() == Move::CASTLING) {
+            bool isKingside = (to > from);
+            int rookFrom = isKingside ? to + 1 : to - 2;
+            int rookTo = isKingside ? to - 1 : to + 1;
+            p.removePiece(ROOK, us, rookFrom);
+            p.putPiece(ROOK, us, rookTo);
+        }
+
+        // Only record an en passant square when an enemy pawn can actually
+        // capture there, so transpositions hash (and print) identically
+        if (p.ep_square != NO_SQUARE) p.key ^= zobrist.ep_file[fileOf(p.ep_square)];
+        p.ep_square = NO_SQUARE;
+        if (piece == PAWN && abs(to - from) == 16) {
+            int epSquare = (from + to) / 2;
+            if (pawnAttacks(us, epSquare) & p.pieces[them][PAWN]) {
+                p.ep_square = static_cast<int8_t>(epSquare);
+                p.key ^= zobrist.ep_file[fileOf(epSquare)];
+            }
+        }
+
+        if (piece == PAWN || captured != NONE) {
+            p.halfmove_clock = 0;
+        } else {
+            p.halfmove_clock++;
+        }
+
+        p.key ^= zobrist.castling[p.castling];
+        p.castling &= ~(castlingRightsLost(from) | castlingRightsLost(to));
+        p.key ^= zobrist.castling[p.castling];
+
+        p.side_to_move = static_cast<uint8_t>(them);
+        p.key ^= zobrist.black_to_move;
+        return captured;
+    }
+
+    // Serialize the position; getFEN() caches the result
+    string buildFEN() const {
+        string fen;
+        fen.reserve(90);
+
+        // Board position
+        for (int rank = 7; rank >= 0; rank--) {
+            int emptyCount = 0;
+            for (int file = 0; file < 8; file++) {
+                int sq = makeSquare(file, rank);
+                PieceType pieceType = pos.pieceAt(sq);
+                if (pieceType == NONE) {
+                    emptyCount++;
+                } else {
+                    if (emptyCount > 0) {
+                        fen += to_string(emptyCount);
+                        emptyCount = 0;
+                    }
+                    char piece;
+                    switch (pieceType) {
+                        case KING:   piece = 'k'; break;
+                        case QUEEN:  piece = 'q'; break;
+                        case ROOK:   piece = 'r'; break;
+                        case BISHOP: piece = 'b'; break;
+                        case KNIGHT: piece = 'n'; break;
+                        case PAWN:   piece = 'p'; break;
+                        default:     piece = '?'; break;
+                    }
+                    if (pos.isWhiteAt(sq)) {
+                        piece = toupper(piece);
+                    }
+                    fen += piece;
+                }
+            }
+            if (emptyCount > 0) {
+                fen += to_string(emptyCount);
+            }
+            if (rank > 0) {
+                fen += '/';
+            }
+        }
+
+        // Active color
+        fen += (turn % 2 == 0) ? " w " : " b ";
+
+        // Castling rights
+        string castling = "";
+        if (pos.castling & WHITE_OO) castling += "K";
+        if (pos.castling & WHITE_OOO) castling += "Q";
+        if (pos.castling & BLACK_OO) castling += "k";
+        if (pos.castling & BLACK_OOO) castling += "q";
+        fen += (castling.empty() ? "-" : castling);
+
+        // En passant target (only when a capture is possible), halfmove clock, fullmove number
+        fen += ' ';
+        fen += (pos.ep_square == NO_SQUARE) ? "-" : positionToNotation(pos.ep_square);
+        fen += ' ' + to_string(pos.halfmove_clock);
+        fen += ' ' + to_string((turn / 2) + 1);
+
+        return fen;
+    }
+
+public:
     ChessGame() {
-        board.resize(8, vector<PieceType>(8, NONE));
-        is_white.resize(8, vector<bool>(8, true));
-        move_history.clear();
+        undo_stack.reserve(256);
+        move_history.reserve(256);
         turn = 0;
         is_ended = false;
         result = ONGOING;
-        
-        // Initialize castling rights
-        white_king_moved = false;
-        white_rook_a_moved = false;
-        white_rook_h_moved = false;
-        black_king_moved = false;
-        black_rook_a_moved = false;
-        black_rook_h_moved = false;
-        
+        end_reason = END_NONE;
+        version = 0;
+        fen_cache_version = 0;
+
         initializeBoard();
     }
-    
+
     void initializeBoard() {
-        // Black pieces (top)
-        board[0] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
-        board[1] = vector<PieceType>(8, PAWN);
-        for (int i = 0; i < 8; i++) {
-            is_white[0][i] = false;
-            is_white[1][i] = false;
-        }
-        
-        // White pieces (bottom)
-        board[6] = vector<PieceType>(8, PAWN);
-        board[7] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
-        for (int i = 0; i < 8; i++) {
-            is_white[6][i] = true;
-            is_white[7][i] = true;
+        static const PieceType backRank[8] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
+
+        pos.clear();
+        for (int file = 0; file < 8; file++) {
+            // White pieces (bottom)
+            pos.putPiece(backRank[file], WHITE, makeSquare(file, 0));
+            pos.putPiece(PAWN, WHITE, makeSquare(file, 1));
+
+            // Black pieces (top)
+            pos.putPiece(PAWN, BLACK, makeSquare(file, 6));
+            pos.putPiece(backRank[file], BLACK, makeSquare(file, 7));
         }
+
+        // Initialize castling rights
+        pos.castling = ALL_CASTLING;
+        pos.side_to_move = WHITE;
+        pos.key = pos.computeKey();
+        version++;
     }
 
-    bool checkMove(string move) {
-        if (is_ended) return false;
-        
-        // Expected format: "e2e4" (from position to position) or "e7e8q" (with promotion)
-        if (move.length() != 4 && move.length() != 5)
-            return false;
-        
-        string from = move.substr(0, 2);
-        string to = move.substr(2, 2);
-        
-        int fromRow, fromCol, toRow, toCol;
-        if (!parsePosition(from, fromRow, fromCol) || !parsePosition(to, toRow, toCol)) 
-            return false;
-        
-        // Check if there's a piece at source
-        if (board[fromRow][fromCol] == NONE) return false;
-        
-        // Check if it's the correct player's turn
-        bool currentPlayerIsWhite = (turn % 2 == 0);
-        if (is_white[fromRow][fromCol] != currentPlayerIsWhite) return false;
-        
-        // Check if trying to capture own piece
-        if (board[toRow][toCol] != NONE && is_white[toRow][toCol] == currentPlayerIsWhite) 
-            return false;
-        
-        // Check for castling
-        PieceType piece = board[fromRow][fromCol];
+    // Match a requested move (squares plus optional promotion, as parsed by
+    // Move::fromString) against the legal moves of the side to move.
+    // Returns the fully encoded legal move, or the null move if illegal.
+    Move resolveMove(Move requested) const {
+        if (is_ended || requested.isNull()) return Move();
 
         // Promotion validation:
-        // - If a 5th char is provided, it must be a pawn promoting on the last rank.
-        // - If no 5th char is provided and a pawn reaches the last rank, we allow it
-        //   (auto-promotes to Queen in move()).
-        if (move.length() == 5) {
-            if (piece != PAWN) return false;
-            int promotionRank = currentPlayerIsWhite ? 0 : 7;
-            if (toRow != promotionRank) return false;
-            PieceType promotionPiece;
-            if (!parsePromotion(move[4], promotionPiece)) return false;
-        }
+        // - If a promotion piece is given, it must be a pawn promoting on the last rank.
+        // - If none is given and a pawn reaches the last rank, we allow it
+        //   (auto-promotes to Queen).
+        bool promotionRequested = (requested.kind() == Move::PROMOTION);
+        PieceType promotionPiece = promotionRequested ? requested.promotion() : QUEEN;
 
-        // Check for castling
-        if (piece == KING && abs(toCol - fromCol) == 2) {
-            return canCastle(fromRow, fromCol, toRow, toCol, currentPlayerIsWhite);
+        // The move is legal exactly when the generator produces it for the side to move
+        MoveList legal;
+        generateLegalMoves(pos, pos.side_to_move, legal);
+        for (Move m : legal) {
+            if (m.from() != requested.from() || m.to() != requested.to()) continue;
+            if (m.kind() != Move::PROMOTION) return promotionRequested ? Move() : m;
+            if (m.promotion() == promotionPiece) return m;
         }
 
-        // Validate piece-specific move
-        if (!isValidPieceMove(piece, fromRow, fromCol, toRow, toCol, currentPlayerIsWhite)) {
-            return false;
-        }
+        return Move();
+    }
 
-        // CRITICAL: Check if this move would leave own king in check
-        if (wouldBeInCheckAfterMove(fromRow, fromCol, toRow, toCol)) {
-            return false;
-        }
+    bool checkMove(Move move) {
+        return !resolveMove(move).isNull();
+    }
 
+    bool move(Move requested) {
+        Move m = resolveMove(requested);
+        if (m.isNull()) return false;
+
+        // Record the move for the game log; the text is built lazily by getGameLog()
+        MoveRecord record;
+        record.move = m;
+        record.piece = static_cast<uint8_t>(pos.pieceAt(m.from()));
+        record.captured = static_cast<uint8_t>((m.kind() == Move::EN_PASSANT) ? PAWN : pos.pieceAt(m.to()));
+        move_history.push_back(record);
+
+        // Execute move
+        makeMove(m);
+
+        checkGameEnd();
         return true;
     }
 
-    bool move(string move) {
-        if (!checkMove(move)) return false;
-        
-        string from = move.substr(0, 2);
-        string to = move.substr(2, 2);
-        
-        int fromRow, fromCol, toRow, toCol;
-        parsePosition(from, fromRow, fromCol);
-        parsePosition(to, toRow, toCol);
-        
-        PieceType piece = board[fromRow][fromCol];
-        bool pieceIsWhite = is_white[fromRow][fromCol];
-        bool isCapture = (board[toRow][toCol] != NONE);
-
-        // Check for pawn promotion
-        PieceType promotionPiece = NONE;
-        bool isPromotion = false;
-        if (piece == PAWN) {
-            int promotionRank = pieceIsWhite ? 0 : 7;
-            if (toRow == promotionRank) {
-                // Explicit promotion (underpromotion supported)
-                if (move.length() == 5 && parsePromotion(move[4], promotionPiece)) {
-                    isPromotion = true;
-                }
-                // Auto-queen if no suffix provided
-                else if (move.length() == 4) {
-                    promotionPiece = QUEEN;
-                    isPromotion = true;
-                }
+    // ==== Make/unmake for search ====
+    // makeMove() plays a legal move produced by generateLegalMoves() and
+    // records what unmakeMove() needs to take it back. Neither touches the
+    // game log or the game-over state, and neither allocates once the undo
+    // stack has grown to the search depth.
+    void makeMove(Move m) {
+        UndoInfo undo;
+        undo.key = pos.key;
+        undo.move = m;
+        undo.castling = pos.castling;
+        undo.ep_square = pos.ep_square;
+        undo.halfmove_clock = pos.halfmove_clock;
+        undo.captured = static_cast<uint8_t>(applyMove(pos, m));
+        undo_stack.push_back(undo);
+        turn++;
+        version++;
+    }
+
+    // Pass the turn without moving (null-move pruning). Must not be played
+    // in check. Resets the halfmove clock so isRepetition() never matches a
+    // position from before the pass. Taken back with unmakeMove().
+    void makeNullMove() {
+        UndoInfo undo;
+        undo.key = pos.key;
+        undo.move = Move();
+        undo.castling = pos.castling;
+        undo.ep_square = pos.ep_square;
+        undo.halfmove_clock = pos.halfmove_clock;
+        undo.captured = NONE;
+        undo_stack.push_back(undo);
+
+        if (pos.ep_square != NO_SQUARE) pos.key ^= zobrist.ep_file[fileOf(pos.ep_square)];
+        pos.ep_square = NO_SQUARE;
+        pos.halfmove_clock = 0;
+        pos.side_to_move ^= 1;
+        pos.key ^= zobrist.black_to_move;
+        turn++;
+        version++;
+    }
+
+    void unmakeMove() {
+        if (undo_stack.empty()) return;
+
+        const UndoInfo undo = undo_stack.back();
+        undo_stack.pop_back();
+
+        Move m = undo.move;
+        int them = pos.side_to_move;
+        int us = them ^ 1;
+
+        if (!m.isNull()) {
+            int from = m.from();
+            int to = m.to();
+
+            PieceType moved = pos.pieceAt(to);
+            pos.removePiece(moved, us, to);
+            pos.putPiece(m.kind() == Move::PROMOTION ? PAWN : moved, us, from);
+
+            if (m.kind() == Move::CASTLING) {
+                bool isKingside = (to > from);
+                int rookFrom = isKingside ? to + 1 : to - 2;
+                int rookTo = isKingside ? to - 1 : to + 1;
+                pos.removePiece(ROOK, us, rookTo);
+                pos.putPiece(ROOK, us, rookFrom);
             }
-        }
-        
-        // Handle castling
-        if (piece == KING && abs(toCol - fromCol) == 2) {
-            // Generate log entry before moving
-            string logEntry = generateLogEntry(fromRow, fromCol, toRow, toCol, false, true);
-            move_history.push_back(logEntry);
-            
-            // Move king
-            board[toRow][toCol] = KING;
-            is_white[toRow][toCol] = pieceIsWhite;
-            board[fromRow][fromCol] = NONE;
-            
-            // Move rook
-            bool isKingside = (toCol > fromCol);
-            int rookFromCol = isKingside ? 7 : 0;
-            int rookToCol = isKingside ? toCol - 1 : toCol + 1;
-            
-            board[toRow][rookToCol] = ROOK;
-            is_white[toRow][rookToCol] = pieceIsWhite;
-            board[toRow][rookFromCol] = NONE;
-            
-            // Update castling rights
-            if (pieceIsWhite) {
-                white_king_moved = true;
-            } else {
-                black_king_moved = true;
+
+            if (undo.captured != NONE) {
+                int capturedSq = (m.kind() == Move::EN_PASSANT) ? to + (us == WHITE ? -8 : 8) : to;
+                pos.putPiece(static_cast<PieceType>(undo.captured), them, capturedSq);
             }
-            
-            turn++;
-            checkGameEnd();
-            return true;
         }
-        
-        // Generate log entry before moving (for regular moves)
-        string logEntry = generateLogEntry(fromRow, fromCol, toRow, toCol, isCapture, false, promotionPiece);
-        
-        // Update castling rights before moving
-        if (piece == KING) {
-            if (pieceIsWhite) white_king_moved = true;
-            else black_king_moved = true;
-        } else if (piece == ROOK) {
-            if (pieceIsWhite) {
-                if (fromRow == 7 && fromCol == 0) white_rook_a_moved = true;
-                if (fromRow == 7 && fromCol == 7) white_rook_h_moved = true;
-            } else {
-                if (fromRow == 0 && fromCol == 0) black_rook_a_moved = true;
-                if (fromRow == 0 && fromCol == 7) black_rook_h_moved = true;
-            }
+
+        pos.castling = undo.castling;
+        pos.ep_square = undo.ep_square;
+        pos.halfmove_clock = undo.halfmove_clock;
+        pos.side_to_move = static_cast<uint8_t>(us);
+        pos.key = undo.key;
+        turn--;
+        version++;
+    }
+
+    // 64-bit Zobrist hash of the current position
+    uint64_t getHash() const {
+        return pos.key;
+    }
+
+    // Zobrist hash of the pawns only; equal for equal pawn structures
+    uint64_t getPawnKey() const {
+        return pos.pawn_key;
+    }
+
+    // Plies since the last capture or pawn move (fifty-move rule at 100)
+    int getHalfmoveClock() const {
+        return pos.halfmove_clock;
+    }
+
+    // True if the current position already occurred since the last capture
+    // or pawn move. Only positions with the same side to move can match, and
+    // none can lie further back than the halfmove clock.
+    bool isRepetition() const {
+        int limit = std::min<int>(pos.halfmove_clock, static_cast<int>(undo_stack.size()));
+        for (int back = 4; back <= limit; back += 2) {
+            if (undo_stack[undo_stack.size() - back].key == pos.key) return true;
         }
-        
-        // Execute move
-        if (isPromotion)
-        {
-            // Pawn promotion: place promoted piece instead of pawn
-            board[toRow][toCol] = promotionPiece;
-        }
-        else
-        {
-            // Regular move
-        board[toRow][toCol] = board[fromRow][fromCol];
-        }
-        is_white[toRow][toCol] = is_white[fromRow][fromCol];
-        board[fromRow][fromCol] = NONE;
-        
-        move_history.push_back(logEntry);
-        turn++;
-        
-        checkGameEnd();
-        return true;
+        return false;
     }
 
     bool checkGameEnd() {
         if (is_ended) return true;
-        
+
         // Determine whose turn it is NOW (after the move was made)
         bool currentPlayerIsWhite = (turn % 2 == 0);
-        
+
         // Check for checkmate
         if (isCheckmate(currentPlayerIsWhite)) {
             is_ended = true;
             // The player who just moved (opposite color) wins
             result = currentPlayerIsWhite ? BLACK_WIN : WHITE_WIN;
+            end_reason = END_CHECKMATE;
             cout << "[ChessGame] CHECKMATE! " << (currentPlayerIsWhite ? "Black" : "White") << " wins!" << endl;
             return true;
         }
-        
+
         // Check for stalemate
         if (isStalemate(currentPlayerIsWhite)) {
             is_ended = true;
             result = DRAW;
+            end_reason = END_STALEMATE;
             cout << "[ChessGame] STALEMATE! Game is a draw." << endl;
             return true;
         }
-        
-        // Check for draw by move limit (simplified: 100 moves without capture)
-        if (turn >= 200) {
+
+        // Fifty-move rule: 100 plies without a capture or pawn move
+        if (pos.halfmove_clock >= 100) {
             is_ended = true;
             result = DRAW;
-            cout << "[ChessGame] Draw by move limit (100 moves)." << endl;
+            end_reason = END_FIFTY_MOVE_RULE;
+            cout << "[ChessGame] Draw by fifty-move rule." << endl;
             return true;
         }
-        
+
         return false;
     }
-    
+
     // Utility methods
     void displayBoard() {
         cout << "  a b c d e f g h\n";
-        for (int i = 0; i < 8; i++) {
-            cout << (8 - i) << " ";
-            for (int j = 0; j < 8; j++) {
+        for (int rank = 7; rank >= 0; rank--) {
+            cout << (rank + 1) << " ";
+            for (int file = 0; file < 8; file++) {
+                int sq = makeSquare(file, rank);
                 char symbol = '.';
-                if (board[i][j] != NONE) {
-                    switch (board[i][j]) {
+                PieceType piece = pos.pieceAt(sq);
+                if (piece != NONE) {
+                    switch (piece) {
                         case KING: symbol = 'K'; break;
                         case QUEEN: symbol = 'Q'; break;
                         case ROOK: symbol = 'R'; break;
@@ -516,190 +869,204 @@ public:
                         case PAWN: symbol = 'P'; break;
                         default: symbol = '?';
                     }
-                    if (!is_white[i][j]) symbol = tolower(symbol);
+                    if (!pos.isWhiteAt(sq)) symbol = tolower(symbol);
                 }
                 cout << symbol << " ";
             }
-            cout << (8 - i) << "\n";
+            cout << (rank + 1) << "\n";
         }
         cout << "  a b c d e f g h\n";
     }
-    
+
+    // Descriptive game log, e.g. "12. White - Knight from g1 to f3 (captures Pawn)"
+    vector<string> getGameLog() const {
+        vector<string> log;
+        log.reserve(move_history.size());
+        int firstTurn = turn - static_cast<int>(move_history.size());
+        for (size_t i = 0; i < move_history.size(); i++) {
+            log.push_back(generateLogEntry(move_history[i], firstTurn + static_cast<int>(i)));
+        }
+        return log;
+    }
+
     void displayGameLog() {
         cout << "\n=== Game Log ===\n";
-        for (size_t i = 0; i < move_history.size(); i++) {
-            cout << move_history[i] << "\n";
+        for (const string& entry : getGameLog()) {
+            cout << entry << "\n";
         }
         cout << "================\n";
     }
 
-    string getFEN() {
-        string fen = "";
-        
-        // Board position
-        for (int row = 0; row < 8; row++) {
-            int emptyCount = 0;
-            for (int col = 0; col < 8; col++) {
-                if (board[row][col] == NONE) {
-                    emptyCount++;
-                } else {
-                    if (emptyCount > 0) {
-                        fen += to_string(emptyCount);
-                        emptyCount = 0;
-                    }
-                    char piece;
-                    switch (board[row][col]) {
-                        case KING:   piece = 'k'; break;
-                        case QUEEN:  piece = 'q'; break;
-                        case ROOK:   piece = 'r'; break;
-                        case BISHOP: piece = 'b'; break;
-                        case KNIGHT: piece = 'n'; break;
-                        case PAWN:   piece = 'p'; break;
-                        default:     piece = '?'; break;
-                    }
-                    if (is_white[row][col]) {
-                        piece = toupper(piece);
-                    }
-                    fen += piece;
+    // Set up the board from a FEN string. The halfmove clock and fullmove
+    // number are optional and default to "0 1". Returns false and leaves the
+    // game untouched if the FEN is malformed or describes an illegal position.
+    bool loadFEN(const string& fen) {
+        istringstream fields(fen);
+        string placement, side, castling, ep;
+        if (!(fields >> placement >> side >> castling >> ep)) return false;
+
+        int halfmove = 0, fullmove = 1;
+        if (fields >> halfmove) {
+            if (!(fields >> fullmove)) return false;
+        } else if (!fields.eof()) {
+            return false;
+        }
+        if (halfmove < 0 || halfmove > 1000 || fullmove < 1 || fullmove > 10000) return false;
+
+        Position p;
+        p.clear();
+
+        // Board position, rank 8 first
+        int rank = 7, file = 0;
+        for (char c : placement) {
+            if (c == '/') {
+                if (file != 8 || rank == 0) return false;
+                rank--;
+                file = 0;
+            } else if (c >= '1' && c <= '8') {
+                file += c - '0';
+                if (file > 8) return false;
+            } else {
+                PieceType piece;
+                switch (tolower(c)) {
+                    case 'k': piece = KING; break;
+                    case 'q': piece = QUEEN; break;
+                    case 'r': piece = ROOK; break;
+                    case 'b': piece = BISHOP; break;
+                    case 'n': piece = KNIGHT; break;
+                    case 'p': piece = PAWN; break;
+                    default: return false;
                 }
-            }
-            if (emptyCount > 0) {
-                fen += to_string(emptyCount);
-            }
-            if (row < 7) {
-                fen += '/';
+                if (file > 7) return false;
+                p.putPiece(piece, isupper(c) ? WHITE : BLACK, makeSquare(file, rank));
+                file++;
             }
         }
-        
+        if (rank != 0 || file != 8) return false;
+        if (popCount(p.pieces[WHITE][KING]) != 1 || popCount(p.pieces[BLACK][KING]) != 1) return false;
+        if ((p.pieces[WHITE][PAWN] | p.pieces[BLACK][PAWN]) & (RANK_1_BB | RANK_8_BB)) return false;
+
         // Active color
-        fen += (turn % 2 == 0) ? " w " : " b ";
-        
+        if (side == "w") p.side_to_move = WHITE;
+        else if (side == "b") p.side_to_move = BLACK;
+        else return false;
+
         // Castling rights
-        string castling = "";
-        if (!white_king_moved) {
-            if (!white_rook_h_moved) castling += "K";
-            if (!white_rook_a_moved) castling += "Q";
+        if (castling != "-") {
+            for (char c : castling) {
+                switch (c) {
+                    case 'K': p.castling |= WHITE_OO; break;
+                    case 'Q': p.castling |= WHITE_OOO; break;
+                    case 'k': p.castling |= BLACK_OO; break;
+                    case 'q': p.castling |= BLACK_OOO; break;
+                    default: return false;
+                }
+            }
         }
-        if (!black_king_moved) {
-            if (!black_rook_h_moved) castling += "k";
-            if (!black_rook_a_moved) castling += "q";
+
+        // Drop rights whose king or rook is not on its home square
+        static const int rookHome[4] = {7, 0, 63, 56};  // WHITE_OO, WHITE_OOO, BLACK_OO, BLACK_OOO
+        for (int i = 0; i < 4; i++) {
+            int color = (i < 2) ? WHITE : BLACK;
+            int kingHome = (color == WHITE) ? 4 : 60;
+            if (!(p.pieces[color][KING] & squareBB(kingHome)) || !(p.pieces[color][ROOK] & squareBB(rookHome[i]))) {
+                p.castling &= ~(1 << i);
+            }
         }
-        fen += (castling.empty() ? "-" : castling);
-        
-        // En passant, halfmove, fullmove (simplified)
-        fen += " - 0 " + to_string((turn / 2) + 1);
-        
-        return fen;
+
+        // En passant square: it must be the square the opponent's pawn just
+        // skipped, or a capture there would remove a pawn that is not on the
+        // board. Kept only when a pawn can actually capture there.
+        if (ep != "-") {
+            int us = p.side_to_move;
+            char epRank = (us == WHITE) ? '6' : '3';
+            if (ep.length() != 2 || ep[0] < 'a' || ep[0] > 'h' || ep[1] != epRank) return false;
+            int epSquare = makeSquare(ep[0] - 'a', ep[1] - '1');
+            int pushed = (us == WHITE) ? epSquare - 8 : epSquare + 8;
+            int origin = (us == WHITE) ? epSquare + 8 : epSquare - 8;
+            if (!(p.pieces[us ^ 1][PAWN] & squareBB(pushed)) || (p.all & (squareBB(epSquare) | squareBB(origin)))) {
+                return false;
+            }
+            if (pawnAttacks(us ^ 1, epSquare) & p.pieces[us][PAWN]) {
+                p.ep_square = static_cast<int8_t>(epSquare);
+            }
+        }
+
+        // The side that just moved cannot be left in check
+        int them = p.side_to_move ^ 1;
+        if (isSquareUnderAttack(p, p.kingSquare(them), p.side_to_move == WHITE)) return false;
+
+        p.halfmove_clock = static_cast<uint16_t>(halfmove);
+        p.key = p.computeKey();
+
+        pos = p;
+        undo_stack.clear();
+        move_history.clear();
+        turn = (fullmove - 1) * 2 + p.side_to_move;
+        version++;
+        is_ended = false;
+        result = ONGOING;
+        end_reason = END_NONE;
+        checkGameEnd();
+        return true;
     }
-    
-    // Find king position for a specific color
+
+    // Build a game from a FEN string, or nullopt if it is not valid
+    static optional<ChessGame> fromFEN(const string& fen) {
+        ChessGame game;
+        if (!game.loadFEN(fen)) return nullopt;
+        return game;
+    }
+
+    // FEN of the current position, rebuilt only after the position changed
+    const string& getFEN() const {
+        if (fen_cache_version != version) {
+            fen_cache = buildFEN();
+            fen_cache_version = version;
+        }
+        return fen_cache;
+    }
+
+    // Position version; changes whenever a move is made, taken back or loaded
+    uint64_t getVersion() const {
+        return version;
+    }
+
+    // Find king position for a specific color (row 0 = rank 8, col 0 = file a)
     bool findKingPosition(bool isWhite, int& kingRow, int& kingCol) {
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                if (board[i][j] == KING && is_white[i][j] == isWhite) {
-                    kingRow = i;
-                    kingCol = j;
-                    return true;
-                }
-            }
+        int sq = pos.kingSquare(isWhite ? WHITE : BLACK);
+        if (sq == NO_SQUARE) {
+            return false; // King not found (shouldn't happen in valid game)
         }
-        return false; // King not found (shouldn't happen in valid game)
+        kingRow = 7 - rankOf(sq);
+        kingCol = fileOf(sq);
+        return true;
     }
-    
+
     // Check if a specific color's king is in check
-    bool isKingInCheck(bool whiteKing) {
-        int kingRow, kingCol;
-        if (!findKingPosition(whiteKing, kingRow, kingCol)) {
+    bool isKingInCheck(bool whiteKing) const {
+        int kingSq = pos.kingSquare(whiteKing ? WHITE : BLACK);
+        if (kingSq == NO_SQUARE) {
             return false; // King not found
         }
-        
+
         // Check if king's position is under attack by opponent
-        return isSquareUnderAttack(kingRow, kingCol, !whiteKing);
-    }
-    
-    // Check if a move would leave own king in check (illegal move)
-    bool wouldBeInCheckAfterMove(int fromRow, int fromCol, int toRow, int toCol) {
-        // Save current state
-        PieceType capturedPiece = board[toRow][toCol];
-        bool capturedIsWhite = is_white[toRow][toCol];
-        PieceType movingPiece = board[fromRow][fromCol];
-        bool movingIsWhite = is_white[fromRow][fromCol];
-        
-        // Simulate move
-        board[toRow][toCol] = movingPiece;
-        is_white[toRow][toCol] = movingIsWhite;
-        board[fromRow][fromCol] = NONE;
-        
-        // Check if own king is in check after this move
-        bool inCheck = isKingInCheck(movingIsWhite);
-        
-        // Restore board
-        board[fromRow][fromCol] = movingPiece;
-        is_white[fromRow][fromCol] = movingIsWhite;
-        board[toRow][toCol] = capturedPiece;
-        if (capturedPiece != NONE) {
-            is_white[toRow][toCol] = capturedIsWhite;
-        }
-        
-        return inCheck;
+        return isSquareUnderAttack(pos, kingSq, !whiteKing);
     }
-    
+
     // Check if a player has any legal moves
     bool hasLegalMoves(bool isWhite) {
-        // Try all possible moves for all pieces of this color
-        for (int fromRow = 0; fromRow < 8; fromRow++) {
-            for (int fromCol = 0; fromCol < 8; fromCol++) {
-                // Skip if no piece or wrong color
-                if (board[fromRow][fromCol] == NONE) continue;
-                if (is_white[fromRow][fromCol] != isWhite) continue;
-                
-                PieceType piece = board[fromRow][fromCol];
-                
-                // Try all possible destination squares
-                for (int toRow = 0; toRow < 8; toRow++) {
-                    for (int toCol = 0; toCol < 8; toCol++) {
-                        // Skip same square
-                        if (fromRow == toRow && fromCol == toCol) continue;
-                        
-                        // Skip if trying to capture own piece
-                        if (board[toRow][toCol] != NONE && is_white[toRow][toCol] == isWhite) {
-                            continue;
-                        }
-                        
-                        // Check if this is a valid piece move
-                        bool validPieceMove = false;
-                        
-                        // Special handling for castling
-                        if (piece == KING && abs(toCol - fromCol) == 2) {
-                            validPieceMove = canCastle(fromRow, fromCol, toRow, toCol, isWhite);
-                        } else {
-                            validPieceMove = isValidPieceMove(piece, fromRow, fromCol, toRow, toCol, isWhite);
-                        }
-                        
-                        if (!validPieceMove) continue;
-                        
-                        // Check if this move would leave king in check
-                        if (wouldBeInCheckAfterMove(fromRow, fromCol, toRow, toCol)) {
-                            continue;
-                        }
-                        
-                        // Found a legal move!
-                        return true;
-                    }
-                }
-            }
-        }
-        
-        // No legal moves found
-        return false;
+        MoveList legal;
+        generateLegalMoves(pos, isWhite ? WHITE : BLACK, legal);
+        return !legal.empty();
     }
-    
+
     // Check if current position is checkmate
     bool isCheckmate(bool isWhite) {
         // Checkmate = in check AND no legal moves
         return isKingInCheck(isWhite) && !hasLegalMoves(isWhite);
     }
-    
+
     // Check if current position is stalemate
     bool isStalemate(bool isWhite) {
         // Stalemate = NOT in check AND no legal moves
@@ -707,78 +1074,117 @@ public:
     }
 
     // ==== Helpers for server-side AI ====
-    bool isWhiteToMove() {
+    bool isWhiteToMove() const {
         return (turn % 2 == 0);
     }
 
-    // Material-only evaluation: positive means white is ahead.
-    int evaluateMaterialScore() {
-        auto value = [](PieceType p) -> int {
-            switch (p) {
-                case PAWN: return 100;
-                case KNIGHT: return 320;
-                case BISHOP: return 330;
-                case ROOK: return 500;
-                case QUEEN: return 900;
-                case KING: return 20000;
-                default: return 0;
-            }
-        };
-
-        int score = 0;
-        for (int r = 0; r < 8; r++) {
-            for (int c = 0; c < 8; c++) {
-                if (board[r][c] == NONE) continue;
-                int v = value(board[r][c]);
-                score += is_white[r][c] ? v : -v;
-            }
-        }
-        return score;
+    // Tapered material + piece-square evaluation: positive means white is
+    // ahead. The sums are kept up to date on every move, so this is O(1).
+    int evaluate() const {
+        return taper(pos.psq_mg, pos.psq_eg);
     }
 
-    vector<string> getLegalMovesForCurrentPlayer() {
-        return getLegalMoves(isWhiteToMove());
+    // Blend a middlegame and an endgame score by the current game phase
+    int taper(int mg, int eg) const {
+        // Promotions can push the phase past the opening value
+        int phase = std::min<int>(pos.phase, PHASE_MAX);
+        return (mg * phase + eg * (PHASE_MAX - phase)) / PHASE_MAX;
     }
 
-    vector<string> getLegalMoves(bool forWhite) {
-        vector<string> moves;
-        if (is_ended) return moves;
+    Bitboard getPieces(int color, PieceType piece) const {
+        return pos.pieces[color][piece];
+    }
 
-        for (int fromRow = 0; fromRow < 8; fromRow++) {
-            for (int fromCol = 0; fromCol < 8; fromCol++) {
-                if (board[fromRow][fromCol] == NONE) continue;
-                if (is_white[fromRow][fromCol] != forWhite) continue;
+    Bitboard getOccupied() const {
+        return pos.all;
+    }
 
-                PieceType piece = board[fromRow][fromCol];
+    PieceType pieceOn(int sq) const {
+        return pos.pieceAt(sq);
+    }
 
-                for (int toRow = 0; toRow < 8; toRow++) {
-                    for (int toCol = 0; toCol < 8; toCol++) {
-                        if (fromRow == toRow && fromCol == toCol) continue;
-                        if (board[toRow][toCol] != NONE && is_white[toRow][toCol] == forWhite) continue;
+    bool isCapture(Move m) const {
+        return m.kind() == Move::EN_PASSANT ||
+               (m.kind() != Move::CASTLING && (pos.all & squareBB(m.to())));
+    }
 
-                        bool validPieceMove = false;
-                        if (piece == KING && abs(toCol - fromCol) == 2 && fromRow == toRow) {
-                            validPieceMove = canCastle(fromRow, fromCol, toRow, toCol, forWhite);
-                        } else {
-                            validPieceMove = isValidPieceMove(piece, fromRow, fromCol, toRow, toCol, forWhite);
-                        }
+    // Static exchange evaluation: material won by the side making move m
+    // once every capture on the target square has been played out, each side
+    // recapturing with its least valuable attacker and stopping when that
+    // would lose material. Pins are ignored.
+    int staticExchange(Move m) const {
+        static const int value[7] = {20000, 900, 500, 330, 320, 100, 0}; // indexed by PieceType
 
-                        if (!validPieceMove) continue;
-                        if (wouldBeInCheckAfterMove(fromRow, fromCol, toRow, toCol)) continue;
+        if (m.kind() == Move::CASTLING) return 0;
 
-                        string mv = positionToNotation(fromRow, fromCol) + positionToNotation(toRow, toCol);
-                        moves.push_back(mv);
-                    }
-                }
-            }
+        int from = m.from();
+        int to = m.to();
+        int side = pos.isWhiteAt(from) ? WHITE : BLACK;
+        Bitboard occupied = pos.all ^ squareBB(from);
+
+        int swap[32];
+        int n = 1;
+        int onSquare = value[pos.pieceAt(from)];
+        if (m.kind() == Move::EN_PASSANT) {
+            swap[0] = value[PAWN];
+            occupied ^= squareBB(to + (side == WHITE ? -8 : 8));
+        } else {
+            swap[0] = value[pos.pieceAt(to)];
+        }
+        if (m.kind() == Move::PROMOTION) {
+            swap[0] += value[m.promotion()] - value[PAWN];
+            onSquare = value[m.promotion()];
+        }
+
+        side ^= 1;
+        while (n < 32) {
+            Bitboard attackers = attackersTo(pos, to, occupied) & occupied;
+            Bitboard ours = attackers & pos.occupied[side];
+            if (!ours) break;
+
+            int pt = PAWN;
+            while (!(ours & pos.pieces[side][pt])) pt--;  // PAWN, KNIGHT, ... KING
+            if (pt == KING && (attackers & pos.occupied[side ^ 1])) break;
+
+            swap[n] = onSquare - swap[n - 1];
+            n++;
+            onSquare = value[pt];
+            occupied ^= squareBB(lsb(ours & pos.pieces[side][pt]));
+            side ^= 1;
+        }
+
+        // Either side may decline to continue the exchange
+        while (--n) {
+            swap[n - 1] = -std::max(-swap[n - 1], swap[n]);
         }
+        return swap[0];
+    }
 
+    // Legal moves for the side to move, written into a caller-owned buffer
+    void generateLegalMoves(MoveList& list) const {
+        list.count = 0;
+        if (is_ended) return;
+        generateLegalMoves(pos, pos.side_to_move, list);
+    }
+
+    vector<Move> getLegalMovesForCurrentPlayer() {
+        return getLegalMoves(isWhiteToMove());
+    }
+
+    vector<Move> getLegalMoves(bool forWhite) {
+        vector<Move> moves;
+        if (is_ended) return moves;
+
+        MoveList legal;
+        generateLegalMoves(pos, forWhite ? WHITE : BLACK, legal);
+        moves.assign(legal.begin(), legal.end());
         return moves;
     }
-    
-    GameResult getResult() { return result; }
-    bool isEnded() { return is_ended; }
-    int getTurn() { return turn; }
+
+    GameResult getResult() const { return result; }
+    GameEndReason getEndReason() const { return end_reason; }
+    bool isEnded() const { return is_ended; }
+    int getTurn() const { return turn; }
 };
 
 // int main() {
@@ -801,7 +1207,7 @@ public:
 //             continue;
 //         }
         
-//         if (game.move(input)) {
+//         if (game.move(Move::fromString(input))) {
 //             cout << "Move executed successfully!\n";
 //             game.displayBoard();
 //         } else {
@@ -825,4 +1231,4 @@ public:
 #endif // CHESS_GAME_CPP
     
 //     return 0;
-// }
\ No newline at end of file
+// }
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "../database/game_repository.h"
 #include "../database/user_repository.h"
 #include "../ai/chess_ai.h"
+#include "../ai/ai_worker_pool.h"
+#include "../ai/opening_book.h"
+#include "../ai/endgame_bitbase.h"
+#include "../ai/ai_result_cache.h"
 #include "../utils/message_types.h"
 #include <iostream>
 #include <random>
@@ -12,11 +16,14 @@
 std::map<std::string, Challenge*> MatchManager::active_challenges;
 std::map<int, std::string> MatchManager::challenges_by_challenger;
 std::map<int, std::string> MatchManager::challenges_by_target;
-std::map<int, GameInstance*> MatchManager::active_games;
+std::map<int, std::shared_ptr<GameInstance>> MatchManager::active_games;
 std::map<int, int> MatchManager::player_to_game;
 pthread_mutex_t MatchManager::mutex;
 BroadcastCallback MatchManager::broadcast_callback = nullptr;
 MatchManager* MatchManager::instance = nullptr;
+size_t MatchManager::ai_hash_mb = TranspositionTable::DEFAULT_SIZE_MB;
+int MatchManager::ai_threads_per_game = 4;
+bool MatchManager::ai_ponder_enabled = true;
 
 MatchManager::MatchManager() {
     pthread_mutex_init(&mutex, nullptr);
@@ -32,10 +39,6 @@ MatchManager::~MatchManager() {
     active_challenges.clear();
     
     // Cleanup games
-    for (auto& pair : active_games) {
-        delete pair.second->chess_engine;
-        delete pair.second;
-    }
     active_games.clear();
 }
 
@@ -55,6 +58,18 @@ void MatchManager::set_broadcast_callback(BroadcastCallback callback) {
     broadcast_callback = callback;
 }
 
+void MatchManager::set_ai_hash_mb(size_t mb) {
+    ai_hash_mb = mb;
+}
+
+void MatchManager::set_ai_threads_per_game(int threads) {
+    ai_threads_per_game = (threads < 1) ? 1 : threads;
+}
+
+void MatchManager::set_ai_ponder(bool enabled) {
+    ai_ponder_enabled = enabled;
+}
+
 std::string MatchManager::generate_challenge_id() {
     static std::random_device rd;
     static std::mt19937 gen(rd());
@@ -84,9 +99,37 @@ std::string game_result_from_enum(GameResult result) {
     return "DRAW";
 }
 
+// GAME_ENDED reason for a game the engine itself ended
+std::string end_reason_from_enum(GameEndReason reason) {
+    if (reason == END_STALEMATE) return "stalemate";
+    if (reason == END_FIFTY_MOVE_RULE) return "fifty_move_rule";
+    return "checkmate";
+}
+
 std::string winner_result_for_player(bool player_is_white) {
     return player_is_white ? "WHITE_WIN" : "BLACK_WIN";
 }
+
+json make_ai_error(const std::string& error_code, const std::string& message) {
+    json error_response;
+    error_response["type"] = MessageTypes::ERROR;
+    error_response["error_code"] = error_code;
+    error_response["message"] = message;
+    error_response["severity"] = "error";
+    error_response["timestamp"] = std::time(nullptr);
+    return error_response;
+}
+
+// Search settings for the AI side of a game (called with the mutex held)
+void configure_ai(const GameInstance& game, ChessAI& ai) {
+    if (const AIDifficulty* difficulty = ChessAI::find_difficulty(game.ai_difficulty)) {
+        ai.set_difficulty(*difficulty);
+    }
+    ai.set_depth(game.ai_depth);
+    ai.set_transposition_table(game.ai_tt.get());
+    ai.set_opening_book(OpeningBook::get_instance());
+    ai.set_endgame_bitbase(EndgameBitbase::get_instance());
+}
 }
 
 // ============================================================================
@@ -314,18 +357,20 @@ int MatchManager::create_game(int white_player_id, const std::string& white_user
     
     pthread_mutex_lock(&mutex);
     
-    GameInstance* game = new GameInstance();
+    auto game = std::make_shared<GameInstance>();
     game->game_id = game_id;
     game->white_player_id = white_player_id;
     game->black_player_id = black_player_id;
     game->white_username = white_username;
     game->black_username = black_username;
-    game->chess_engine = new ChessGame();
+    game->chess_engine.reset(new ChessGame());
     game->start_time = std::time(nullptr);
     game->is_active = true;
     game->white_draw_offered = false;
     game->black_draw_offered = false;
+    game->ai_difficulty = "medium";
     game->ai_depth = 2;
+    game->ai_threads = 1;
     game->ai_think_ms = 0;
     game->ai_nodes_searched = 0;
     
@@ -346,8 +391,8 @@ int MatchManager::create_game(int white_player_id, const std::string& white_user
 }
 
 bool MatchManager::accept_ai_challenge(int human_user_id, const std::string& human_username,
-                                       const std::string& preferred_color, int ai_depth,
-                                       int& out_game_id) {
+                                       const std::string& preferred_color, const std::string& ai_difficulty,
+                                       int ai_depth, int& out_game_id) {
     const std::string ai_username = "AI";
     if (ai_depth < 1) ai_depth = 1;
     if (ai_depth > 6) ai_depth = 6;
@@ -386,11 +431,15 @@ bool MatchManager::accept_ai_challenge(int human_user_id, const std::string& hum
         return false;
     }
 
-    // Store AI depth on the instance.
+    // Store AI difficulty, depth, thread budget and a fresh transposition table on the instance.
+    auto ai_tt = std::make_shared<TranspositionTable>(ai_hash_mb);
     pthread_mutex_lock(&mutex);
     auto it = active_games.find(out_game_id);
     if (it != active_games.end() && it->second) {
+        it->second->ai_difficulty = ai_difficulty;
         it->second->ai_depth = ai_depth;
+        it->second->ai_tt = ai_tt;
+        it->second->ai_threads = (ai_depth >= AI_SMP_MIN_DEPTH) ? ai_threads_per_game : 1;
     }
     pthread_mutex_unlock(&mutex);
 
@@ -403,100 +452,41 @@ bool MatchManager::accept_ai_challenge(int human_user_id, const std::string& hum
     match_started["your_color"] = your_color;
     match_started["opponent_username"] = opponent_username;
     match_started["opponent_is_ai"] = true;
+    match_started["ai_difficulty"] = ai_difficulty;
     match_started["ai_depth"] = ai_depth;
 
     broadcast_to_user(human_user_id, match_started);
 
     std::cout << "[MatchManager] AI match started - Game ID: " << out_game_id
               << " | Human: " << human_username << " as " << your_color
-              << " | depth=" << ai_depth << std::endl;
+              << " | difficulty=" << ai_difficulty << " depth=" << ai_depth << std::endl;
 
-    // If AI is white, play the first move immediately.
+    // If AI is white, queue its first move right away.
     if (white_id == AI_USER_ID) {
-        GameInstance* game = get_game(out_game_id);
-        if (game && game->is_active) {
-            ChessAI ai(game->ai_depth);
-            ChessAIMoveResult ai_result;
-            {
-                pthread_mutex_lock(&mutex);
-                ai_result = ai.make_move(*game->chess_engine, /*ai_is_white=*/true);
-                game->ai_think_ms = ai_result.ai_think_ms;
-                game->ai_nodes_searched = ai_result.nodes_searched;
-
-                const std::string& ai_move = ai_result.move;
-                if (!ai_move.empty()) {
-                    bool ok = game->chess_engine->move(ai_move);
-                    if (ok) {
-                        game->move_history.push_back(ai_move);
-                        GameRepository::add_move_to_game(out_game_id, ai_move);
-                    } else {
-                        ai_result.move.clear();
-                    }
-                }
-                pthread_mutex_unlock(&mutex);
-            }
-
-            if (!ai_result.move.empty()) {
-                const int turn = game->chess_engine->getTurn();
-                const bool next_player_is_white = (turn % 2 == 0);
-                const bool opponent_king_in_check = game->chess_engine->isKingInCheck(next_player_is_white);
-
-                json opponent_move;
-                opponent_move["type"] = "OPPONENT_MOVE";
-                opponent_move["game_id"] = out_game_id;
-                opponent_move["move"] = ai_result.move;
-                opponent_move["move_number"] = turn;
-                opponent_move["is_check"] = opponent_king_in_check;
-                opponent_move["captured_piece"] = nullptr;
-                opponent_move["timestamp"] = std::time(nullptr);
-                opponent_move["board_state"] = game->chess_engine->getFEN();
-                opponent_move["current_turn"] = next_player_is_white ? "white" : "black";
-                opponent_move["white_player"] = game->white_username;
-                opponent_move["black_player"] = game->black_username;
-                opponent_move["ai_think_ms"] = game->ai_think_ms;
-                opponent_move["ai_nodes_searched"] = game->ai_nodes_searched;
-
-                broadcast_to_user(human_user_id, opponent_move);
-            } else {
-                if (game->chess_engine->isEnded()) {
-                    end_game(out_game_id, game_result_from_enum(game->chess_engine->getResult()), "checkmate");
-                } else {
-                    json error_response;
-                    error_response["type"] = MessageTypes::ERROR;
-                    error_response["error_code"] = ai_result.timed_out ? "AI_TIMEOUT" : "AI_NO_MOVE";
-                    error_response["message"] = ai_result.timed_out
-                        ? "AI exceeded thinking time"
-                        : "AI could not generate a legal move";
-                    error_response["severity"] = "error";
-                    error_response["timestamp"] = std::time(nullptr);
-                    broadcast_to_user(human_user_id, error_response);
-
-                    end_game(out_game_id, "BLACK_WIN", ai_result.timed_out ? "ai_timeout" : "ai_no_move");
-                }
-            }
-        }
+        request_ai_move(out_game_id);
     }
 
     return true;
 }
 
-GameInstance* MatchManager::get_game(int game_id) {
+std::shared_ptr<GameInstance> MatchManager::get_game(int game_id) {
     pthread_mutex_lock(&mutex);
     auto it = active_games.find(game_id);
-    GameInstance* result = (it != active_games.end()) ? it->second : nullptr;
+    std::shared_ptr<GameInstance> result = (it != active_games.end()) ? it->second : nullptr;
     pthread_mutex_unlock(&mutex);
     return result;
 }
 
-GameInstance* MatchManager::get_game_by_player(int user_id) {
+std::shared_ptr<GameInstance> MatchManager::get_game_by_player(int user_id) {
     pthread_mutex_lock(&mutex);
     auto it = player_to_game.find(user_id);
     if (it != player_to_game.end()) {
         int game_id = it->second;
         auto game_it = active_games.find(game_id);
         if (game_it != active_games.end()) {
+            std::shared_ptr<GameInstance> game = game_it->second;
             pthread_mutex_unlock(&mutex);
-            return game_it->second;
+            return game;
         }
     }
     pthread_mutex_unlock(&mutex);
@@ -522,24 +512,21 @@ bool MatchManager::is_player_in_game(int user_id) {
 // GAMEPLAY OPERATIONS
 // ============================================================================
 
-bool MatchManager::make_move(int game_id, int player_id, const std::string& move, 
+bool MatchManager::make_move(int game_id, int player_id, Move move, 
                             json& out_response, int& out_opponent_id) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game || !game->is_active) {
         return false;
     }
     
-    // Verify it's player's turn
-    bool is_white_turn = (game->chess_engine->getTurn() % 2 == 0);
     bool player_is_white = (player_id == game->white_player_id);
     
-    if (is_white_turn != player_is_white) {
-        return false;  // Not player's turn
-    }
-    
-    // Attempt move
+    // Verify it's player's turn and attempt the move under one lock, so an
+    // AI move committed or a game ended from another thread cannot slip in
+    // between
     pthread_mutex_lock(&mutex);
-    bool move_valid = game->chess_engine->move(move);
+    bool is_white_turn = (game->chess_engine->getTurn() % 2 == 0);
+    bool move_valid = game->is_active && (is_white_turn == player_is_white) && game->chess_engine->move(move);
     pthread_mutex_unlock(&mutex);
     
     if (!move_valid) {
@@ -549,12 +536,13 @@ bool MatchManager::make_move(int game_id, int player_id, const std::string& move
     // Move successful - update database and prepare response
     pthread_mutex_lock(&mutex);
     game->move_history.push_back(move);
-    GameRepository::add_move_to_game(game_id, move);
+    GameRepository::add_move_to_game(game_id, move.toString());
     
     // Get game state
     int turn = game->chess_engine->getTurn();
     bool is_ended = game->chess_engine->isEnded();
     GameResult result = game->chess_engine->getResult();
+    GameEndReason end_reason = game->chess_engine->getEndReason();
     
     // Check if opponent's king is in check after the move
     // After move, turn has been incremented
@@ -567,10 +555,10 @@ bool MatchManager::make_move(int game_id, int player_id, const std::string& move
     // Prepare response
     out_response["type"] = "MOVE_ACCEPTED";
     out_response["game_id"] = game_id;
-    out_response["move"] = move;
+    out_response["move"] = move.toString();
     out_response["move_number"] = turn;
     out_response["is_check"] = opponent_king_in_check;
-    out_response["is_checkmate"] = is_ended;
+    out_response["is_checkmate"] = (end_reason == END_CHECKMATE);
     out_response["board_state"] = game->chess_engine->getFEN();
     out_response["current_turn"] = next_player_is_white ? "white" : "black";
     
@@ -580,7 +568,7 @@ bool MatchManager::make_move(int game_id, int player_id, const std::string& move
     json opponent_move;
     opponent_move["type"] = "OPPONENT_MOVE";
     opponent_move["game_id"] = game_id;
-    opponent_move["move"] = move;
+    opponent_move["move"] = move.toString();
     opponent_move["move_number"] = turn;
     opponent_move["is_check"] = opponent_king_in_check;
     opponent_move["captured_piece"] = nullptr;
@@ -594,94 +582,318 @@ bool MatchManager::make_move(int game_id, int player_id, const std::string& move
     
     broadcast_to_user(out_opponent_id, opponent_move);
     
-    std::cout << "[MatchManager] Move executed in game " << game_id << ": " << move << std::endl;
+    std::cout << "[MatchManager] Move executed in game " << game_id << ": " << move.toString() << std::endl;
     
     // Check if game ended
     if (is_ended) {
-        std::string result_str;
-        if (result == WHITE_WIN) result_str = "WHITE_WIN";
-        else if (result == BLACK_WIN) result_str = "BLACK_WIN";
-        else result_str = "DRAW";
-        
-        end_game(game_id, result_str, "checkmate");
-    }
-
-    // If opponent is AI, auto-play AI move and broadcast to the human.
-    if (!is_ended && out_opponent_id == AI_USER_ID) {
-        GameInstance* latest_game = get_game(game_id);
-        if (latest_game && latest_game->is_active) {
-            const bool ai_is_white = (latest_game->white_player_id == AI_USER_ID);
-            const int human_id = player_id;
-            const bool human_is_white = (human_id == latest_game->white_player_id);
-
-            ChessAI ai(latest_game->ai_depth);
-            ChessAIMoveResult ai_move_result;
-
-            pthread_mutex_lock(&mutex);
-            ai_move_result = ai.make_move(*latest_game->chess_engine, ai_is_white);
-            latest_game->ai_think_ms = ai_move_result.ai_think_ms;
-            latest_game->ai_nodes_searched = ai_move_result.nodes_searched;
-
-            const std::string& ai_move = ai_move_result.move;
-            if (!ai_move.empty()) {
-                bool ok = latest_game->chess_engine->move(ai_move);
-                if (ok) {
-                    latest_game->move_history.push_back(ai_move);
-                    GameRepository::add_move_to_game(game_id, ai_move);
-                } else {
-                    ai_move_result.move.clear();
-                }
-            }
+        end_game(game_id, game_result_from_enum(result), end_reason_from_enum(end_reason));
+    }
 
-            const int new_turn = latest_game->chess_engine->getTurn();
-            const bool ai_is_ended = latest_game->chess_engine->isEnded();
-            const GameResult ai_game_result = latest_game->chess_engine->getResult();
-            const bool next_player_is_white = (new_turn % 2 == 0);
-            const bool opponent_king_in_check_after_ai = latest_game->chess_engine->isKingInCheck(next_player_is_white);
+    return true;
+}
 
-            pthread_mutex_unlock(&mutex);
+AITurnResult MatchManager::play_ai_turn(int game_id) {
+    AITurnResult out;
+    
+    // Snapshot the position so the search does not hold the global mutex
+    pthread_mutex_lock(&mutex);
+    auto it = active_games.find(game_id);
+    if (it == active_games.end() || !it->second->is_active) {
+        pthread_mutex_unlock(&mutex);
+        out.stale = true;
+        return out;
+    }
+    GameInstance* game = it->second.get();
+    const bool ai_is_white = (game->white_player_id == AI_USER_ID);
+    const bool ai_in_game = ai_is_white || (game->black_player_id == AI_USER_ID);
+    if (!ai_in_game || game->chess_engine->isEnded() || game->chess_engine->isWhiteToMove() != ai_is_white) {
+        pthread_mutex_unlock(&mutex);
+        out.stale = true;
+        return out;
+    }
+    out.ai_is_white = ai_is_white;
+    out.human_player_id = ai_is_white ? game->black_player_id : game->white_player_id;
+    ChessGame snapshot = *game->chess_engine;
+    const uint64_t snapshot_version = snapshot.getVersion();
+    // Holding a reference keeps the table alive if the game is cleaned up mid-search
+    std::shared_ptr<TranspositionTable> tt = game->ai_tt;
+    ChessAI ai;
+    configure_ai(*game, ai);
+    const int wanted_helpers = game->ai_threads - 1;
+    const std::string difficulty = game->ai_difficulty;
+    const int depth = game->ai_depth;
+    std::shared_ptr<AIPonder> ponder = std::move(game->ai_ponder);
+    game->ai_ponder.reset();
+    pthread_mutex_unlock(&mutex);
+    
+    const uint64_t position_key = snapshot.getHash();
+    ChessAIMoveResult search{Move(), 0, 0, false, 0, false, 0, false};
+    int helpers = 0;
+    
+    // The human played the expected reply: this position was searched on their time
+    const bool ponder_hit = ponder && finish_ponder(*ponder, position_key, search);
+    
+    // Another AI game may already have searched this position. Only results
+    // that depend on the position alone are shared: noisy levels have to
+    // vary from game to game, and after moves without a capture or pawn move
+    // the search may have scored repetitions or the fifty-move rule from
+    // this game's own history.
+    const AIDifficulty* profile = ChessAI::find_difficulty(difficulty);
+    const bool cacheable = (!profile || profile->eval_noise == 0) && snapshot.getHalfmoveClock() == 0;
+    AIResultCache* cache = AIResultCache::get_instance();
+    CachedAIMove cached;
+    const bool cache_hit = !ponder_hit && cacheable && cache->lookup(snapshot, difficulty, depth, cached);
+    
+    if (ponder_hit) {
+        // search holds the ponder's result
+    } else if (cache_hit) {
+        search.move = cached.move;
+        search.depth_reached = cached.depth_reached;
+        search.score = cached.score;
+    } else {
+        // Extra threads only from whatever the server-wide budget has spare
+        AIWorkerPool* pool = AIWorkerPool::get_instance();
+        helpers = pool->reserve_helper_threads(wanted_helpers);
+        ai.set_threads(1 + helpers);
+        search = ai.make_move(std::move(snapshot), ai_is_white);
+        pool->release_helper_threads(helpers);
+    }
+    
+    // A ponder hit searched on the human's time, to a depth that depends on
+    // how long they thought, so only this turn's own searches are shared
+    if (cacheable && !cache_hit && !ponder_hit) {
+        cache->store(position_key, difficulty, depth, search);
+    }
+    out.timed_out = search.timed_out;
+    
+    // Commit only if nobody touched the game while we were searching
+    pthread_mutex_lock(&mutex);
+    it = active_games.find(game_id);
+    if (it == active_games.end() || !it->second->is_active ||
+        it->second->chess_engine->getVersion() != snapshot_version) {
+        pthread_mutex_unlock(&mutex);
+        std::cout << "[MatchManager] Discarding stale AI move for game " << game_id << std::endl;
+        out.stale = true;
+        return out;
+    }
+    game = it->second.get();
+    game->ai_think_ms = search.ai_think_ms;
+    game->ai_nodes_searched = search.nodes_searched;
+    
+    if (!search.move.isNull() && game->chess_engine->move(search.move)) {
+        game->move_history.push_back(search.move);
+        GameRepository::add_move_to_game(game_id, search.move.toString());
+        out.committed = true;
+    }
+    
+    ChessGame* engine = game->chess_engine.get();
+    out.game_ended = engine->isEnded();
+    out.result = engine->getResult();
+    out.end_reason = engine->getEndReason();
+    
+    if (out.committed) {
+        const int turn = engine->getTurn();
+        const bool next_player_is_white = (turn % 2 == 0);
+        
+        json& opponent_move = out.opponent_move;
+        opponent_move["type"] = "OPPONENT_MOVE";
+        opponent_move["game_id"] = game_id;
+        opponent_move["move"] = search.move.toString();
+        opponent_move["move_number"] = turn;
+        opponent_move["is_check"] = engine->isKingInCheck(next_player_is_white);
+        opponent_move["captured_piece"] = nullptr;
+        opponent_move["timestamp"] = std::time(nullptr);
+        opponent_move["board_state"] = engine->getFEN();
+        opponent_move["current_turn"] = next_player_is_white ? "white" : "black";
+        opponent_move["white_player"] = game->white_username;
+        opponent_move["black_player"] = game->black_username;
+        opponent_move["ai_think_ms"] = game->ai_think_ms;
+        opponent_move["ai_nodes_searched"] = game->ai_nodes_searched;
+        opponent_move["ai_depth_reached"] = search.depth_reached;
+        opponent_move["ai_threads"] = 1 + helpers;
+        opponent_move["ai_book_move"] = search.from_book;
+        opponent_move["ai_cache_hit"] = cache_hit;
+        opponent_move["ai_ponder_hit"] = ponder_hit;
+    }
+    pthread_mutex_unlock(&mutex);
+    
+    return out;
+}
 
-            if (!ai_move_result.move.empty()) {
-                json ai_opponent_move;
-                ai_opponent_move["type"] = "OPPONENT_MOVE";
-                ai_opponent_move["game_id"] = game_id;
-                ai_opponent_move["move"] = ai_move_result.move;
-                ai_opponent_move["move_number"] = new_turn;
-                ai_opponent_move["is_check"] = opponent_king_in_check_after_ai;
-                ai_opponent_move["captured_piece"] = nullptr;
-                ai_opponent_move["timestamp"] = std::time(nullptr);
-                ai_opponent_move["board_state"] = latest_game->chess_engine->getFEN();
-                ai_opponent_move["current_turn"] = next_player_is_white ? "white" : "black";
-                ai_opponent_move["white_player"] = latest_game->white_username;
-                ai_opponent_move["black_player"] = latest_game->black_username;
-                ai_opponent_move["ai_think_ms"] = latest_game->ai_think_ms;
-                ai_opponent_move["ai_nodes_searched"] = latest_game->ai_nodes_searched;
-
-                out_response["ai_followup_move"] = ai_opponent_move;
-            } else if (!ai_is_ended) {
-                json error_response;
-                error_response["type"] = MessageTypes::ERROR;
-                error_response["error_code"] = ai_move_result.timed_out ? "AI_TIMEOUT" : "AI_NO_MOVE";
-                error_response["message"] = ai_move_result.timed_out
-                    ? "AI exceeded thinking time"
-                    : "AI could not generate a legal move";
-                error_response["severity"] = "error";
-                error_response["timestamp"] = std::time(nullptr);
-                out_response["ai_followup_error"] = error_response;
-
-                end_game(game_id,
-                         winner_result_for_player(human_is_white),
-                         ai_move_result.timed_out ? "ai_timeout" : "ai_no_move");
-                return true;
-            }
+void MatchManager::run_ai_turn(int game_id, long long queue_wait_ms) {
+    AITurnResult ai_turn = play_ai_turn(game_id);
+    if (ai_turn.stale) {
+        return;
+    }
+    
+    if (ai_turn.committed) {
+        ai_turn.opponent_move["ai_queue_wait_ms"] = queue_wait_ms;
+        broadcast_to_user(ai_turn.human_player_id, ai_turn.opponent_move);
+        if (!ai_turn.game_ended) {
+            start_ponder(game_id);
+        }
+    } else if (!ai_turn.game_ended) {
+        broadcast_to_user(ai_turn.human_player_id,
+                          ai_turn.timed_out
+                              ? make_ai_error("AI_TIMEOUT", "AI exceeded thinking time")
+                              : make_ai_error("AI_NO_MOVE", "AI could not generate a legal move"));
+        end_game(game_id,
+                 winner_result_for_player(!ai_turn.ai_is_white),
+                 ai_turn.timed_out ? "ai_timeout" : "ai_no_move");
+        return;
+    }
+    
+    if (ai_turn.game_ended) {
+        end_game(game_id, game_result_from_enum(ai_turn.result), end_reason_from_enum(ai_turn.end_reason));
+    }
+}
 
-            if (ai_is_ended) {
-                end_game(game_id, game_result_from_enum(ai_game_result), "checkmate");
-            }
+void MatchManager::start_ponder(int game_id) {
+    if (!ai_ponder_enabled) {
+        return;
+    }
+    
+    // Pondering is a bonus: never let it queue ahead of real AI moves
+    AIWorkerPool* pool = AIWorkerPool::get_instance();
+    AIWorkerPool::Stats pool_stats = pool->get_stats();
+    if (pool_stats.busy_workers + static_cast<int>(pool_stats.queue_depth) >= pool_stats.workers) {
+        return;
+    }
+    
+    // A ponder left over from an earlier turn has to be off the game's
+    // table before another search uses it
+    std::shared_ptr<AIPonder> previous;
+    pthread_mutex_lock(&mutex);
+    auto it = active_games.find(game_id);
+    if (it != active_games.end()) {
+        previous = std::move(it->second->ai_ponder);
+        it->second->ai_ponder.reset();
+    }
+    pthread_mutex_unlock(&mutex);
+    if (previous) {
+        stop_ponder(*previous);
+    }
+    
+    pthread_mutex_lock(&mutex);
+    it = active_games.find(game_id);
+    if (it == active_games.end() || !it->second->is_active || !it->second->ai_tt ||
+        it->second->chess_engine->isEnded() || it->second->ai_ponder) {
+        // Gone, over, or another thread started pondering meanwhile
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    GameInstance* game = it->second.get();
+    const bool ai_is_white = (game->white_player_id == AI_USER_ID);
+    ChessGame position = *game->chess_engine;
+    
+    // The reply the AI's own search expected is the hash move here
+    Move expected;
+    TTHit hit;
+    if (position.isWhiteToMove() != ai_is_white && game->ai_tt->probe(position.getHash(), hit)) {
+        expected = position.resolveMove(hit.move);
+    }
+    if (expected.isNull()) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    position.makeMove(expected);
+    MoveList replies;
+    position.generateLegalMoves(replies);
+    if (replies.empty()) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    
+    auto ponder = std::make_shared<AIPonder>(position.getHash());
+    ChessAI ai;
+    configure_ai(*game, ai);
+    ai.set_stop_flag(&ponder->stop);
+    // Holding a reference keeps the table alive if the game is cleaned up mid-search
+    std::shared_ptr<TranspositionTable> tt = game->ai_tt;
+    game->ai_ponder = ponder;
+    pthread_mutex_unlock(&mutex);
+    
+    // If the queue refuses the job, the ponder never starts and the AI's
+    // turn simply searches
+    pool->submit([ponder, tt, ai, position, ai_is_white](long long) {
+        pthread_mutex_lock(&ponder->mutex);
+        if (ponder->stop.load()) {
+            pthread_mutex_unlock(&ponder->mutex);
+            return;
         }
+        ponder->started = true;
+        pthread_mutex_unlock(&ponder->mutex);
+        
+        ChessAIMoveResult result = ai.make_move(position, ai_is_white);
+        
+        pthread_mutex_lock(&ponder->mutex);
+        ponder->result = result;
+        ponder->finished = true;
+        pthread_cond_broadcast(&ponder->finished_cond);
+        pthread_mutex_unlock(&ponder->mutex);
+    });
+}
+
+bool MatchManager::finish_ponder(AIPonder& ponder, uint64_t position_key, ChessAIMoveResult& out) {
+    pthread_mutex_lock(&ponder.mutex);
+    // A ponder still waiting in the queue is cancelled even on a hit:
+    // waiting for it could take longer than searching
+    const bool hit = ponder.started && ponder.position_key == position_key;
+    // On a hit the ponder runs to its own time and node budget, counted from
+    // when it started, so it plays as strongly as a fresh search. If the
+    // human thought for longer than that, it has already finished.
+    if (!hit) {
+        ponder.stop.store(true);
     }
+    while (ponder.started && !ponder.finished) {
+        pthread_cond_wait(&ponder.finished_cond, &ponder.mutex);
+    }
+    if (hit) {
+        out = ponder.result;
+    }
+    pthread_mutex_unlock(&ponder.mutex);
+    // Out of budget before its first iteration completed: search afresh
+    return hit && !out.move.isNull() && out.depth_reached > 0;
+}
+
+void MatchManager::stop_ponder(AIPonder& ponder) {
+    pthread_mutex_lock(&ponder.mutex);
+    ponder.stop.store(true);
+    while (ponder.started && !ponder.finished) {
+        pthread_cond_wait(&ponder.finished_cond, &ponder.mutex);
+    }
+    pthread_mutex_unlock(&ponder.mutex);
+}
+
+void MatchManager::request_ai_move(int game_id) {
+    pthread_mutex_lock(&mutex);
+    auto it = active_games.find(game_id);
+    bool ai_to_move = false;
+    int human_id = 0;
+    bool ai_is_white = false;
+    if (it != active_games.end() && it->second->is_active && !it->second->chess_engine->isEnded()) {
+        GameInstance* game = it->second.get();
+        ai_is_white = game->chess_engine->isWhiteToMove();
+        int mover_id = ai_is_white ? game->white_player_id : game->black_player_id;
+        ai_to_move = (mover_id == AI_USER_ID);
+        human_id = ai_is_white ? game->black_player_id : game->white_player_id;
+    }
+    pthread_mutex_unlock(&mutex);
     
-    return true;
+    if (!ai_to_move) {
+        return;
+    }
+    
+    bool queued = AIWorkerPool::get_instance()->submit([this, game_id](long long queue_wait_ms) {
+        run_ai_turn(game_id, queue_wait_ms);
+    });
+    
+    if (!queued) {
+        // Shed load rather than blocking this connection thread on a search
+        std::cerr << "[MatchManager] AI queue full, cannot play game " << game_id << std::endl;
+        broadcast_to_user(human_id, make_ai_error("AI_BUSY", "AI is overloaded, please try again later"));
+        end_game(game_id, winner_result_for_player(!ai_is_white), "ai_busy");
+    }
 }
 
 bool MatchManager::handle_player_disconnect(int user_id) {
@@ -690,7 +902,7 @@ bool MatchManager::handle_player_disconnect(int user_id) {
         return false;  // Player not in a game
     }
     
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game || !game->is_active) {
         return false;
     }
@@ -701,14 +913,18 @@ bool MatchManager::handle_player_disconnect(int user_id) {
     std::string loser_username = player_is_white ? game->white_username : game->black_username;
     std::string result = player_is_white ? "BLACK_WIN" : "WHITE_WIN";
     
-    // Mark game as inactive
+    // Mark game as inactive, unless something else ended it meanwhile
     pthread_mutex_lock(&mutex);
+    if (!game->is_active) {
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
     game->is_active = false;
     
     // Convert moves to JSON string
     json moves_json = json::array();
     for (const auto& move : game->move_history) {
-        moves_json.push_back(move);
+        moves_json.push_back(move.toString());
     }
     std::string moves_str = moves_json.dump();
     pthread_mutex_unlock(&mutex);
@@ -744,7 +960,7 @@ bool MatchManager::handle_player_disconnect(int user_id) {
     // Add move history (game log)
     game_ended["move_history"] = json::array();
     for (const auto& move : game->move_history) {
-        game_ended["move_history"].push_back(move);
+        game_ended["move_history"].push_back(move.toString());
     }
     
     broadcast_to_user(winner_id, game_ended);  // Only send to winner (opponent)
@@ -759,7 +975,7 @@ bool MatchManager::handle_player_disconnect(int user_id) {
 }
 
 bool MatchManager::resign_game(int game_id, int player_id, int& out_winner_id, int& out_loser_id) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game || !game->is_active) {
         return false;
     }
@@ -778,7 +994,7 @@ bool MatchManager::resign_game(int game_id, int player_id, int& out_winner_id, i
 }
 
 bool MatchManager::offer_draw(int game_id, int player_id, int& out_opponent_id) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game || !game->is_active) {
         return false;
     }
@@ -813,7 +1029,7 @@ bool MatchManager::offer_draw(int game_id, int player_id, int& out_opponent_id)
 
 bool MatchManager::respond_to_draw(int game_id, int player_id, bool accepted, 
                                    std::string& out_result, int& out_opponent_id) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game || !game->is_active) {
         return false;
     }
@@ -854,7 +1070,7 @@ bool MatchManager::respond_to_draw(int game_id, int player_id, bool accepted,
 // ============================================================================
 
 json MatchManager::get_game_state(int game_id) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     
     json state;
     if (!game) {
@@ -873,12 +1089,13 @@ json MatchManager::get_game_state(int game_id) {
     state["is_ended"] = game->chess_engine->isEnded();
     state["board_state"] = game->chess_engine->getFEN();
     state["is_ai_game"] = (game->white_player_id == AI_USER_ID || game->black_player_id == AI_USER_ID);
+    state["ai_difficulty"] = game->ai_difficulty;
     state["ai_depth"] = game->ai_depth;
     
     // Move history
     state["move_history"] = json::array();
     for (const auto& move : game->move_history) {
-        state["move_history"].push_back(move);
+        state["move_history"].push_back(move.toString());
     }
     
     // Game result
@@ -895,18 +1112,26 @@ json MatchManager::get_game_state(int game_id) {
 }
 
 std::string MatchManager::get_board_fen(int game_id) {
-    // TODO: Implement FEN generation from ChessGame
-    return "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    std::shared_ptr<GameInstance> game = get_game(game_id);
+    if (!game) {
+        return "";
+    }
+    
+    pthread_mutex_lock(&mutex);
+    std::string fen = game->chess_engine->getFEN();
+    pthread_mutex_unlock(&mutex);
+    
+    return fen;
 }
 
-std::vector<std::string> MatchManager::get_move_history(int game_id) {
-    GameInstance* game = get_game(game_id);
+std::vector<Move> MatchManager::get_move_history(int game_id) {
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game) {
-        return std::vector<std::string>();
+        return std::vector<Move>();
     }
     
     pthread_mutex_lock(&mutex);
-    std::vector<std::string> history = game->move_history;
+    std::vector<Move> history = game->move_history;
     pthread_mutex_unlock(&mutex);
     
     return history;
@@ -917,18 +1142,24 @@ std::vector<std::string> MatchManager::get_move_history(int game_id) {
 // ============================================================================
 
 void MatchManager::end_game(int game_id, const std::string& result, const std::string& reason) {
-    GameInstance* game = get_game(game_id);
+    std::shared_ptr<GameInstance> game = get_game(game_id);
     if (!game) {
         return;
     }
     
     pthread_mutex_lock(&mutex);
+    // An AI move, a resignation, a draw and a disconnect can all end the
+    // game at once; only the first records and announces the result
+    if (!game->is_active) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
     game->is_active = false;
     
     // Convert moves to JSON string
     json moves_json = json::array();
     for (const auto& move : game->move_history) {
-        moves_json.push_back(move);
+        moves_json.push_back(move.toString());
     }
     std::string moves_str = moves_json.dump();
     
@@ -999,7 +1230,7 @@ void MatchManager::end_game(int game_id, const std::string& result, const std::s
     // Add move history (game log)
     game_ended["move_history"] = json::array();
     for (const auto& move : game->move_history) {
-        game_ended["move_history"].push_back(move);
+        game_ended["move_history"].push_back(move.toString());
     }
     
     broadcast_to_user(white_id, game_ended);
@@ -1014,23 +1245,30 @@ void MatchManager::end_game(int game_id, const std::string& result, const std::s
 }
 
 void MatchManager::cleanup_game(int game_id) {
+    std::shared_ptr<AIPonder> ponder;
     pthread_mutex_lock(&mutex);
     
     auto it = active_games.find(game_id);
     if (it != active_games.end()) {
-        GameInstance* game = it->second;
+        GameInstance* game = it->second.get();
         
         player_to_game.erase(game->white_player_id);
         player_to_game.erase(game->black_player_id);
         
-        delete game->chess_engine;
-        delete game;
+        ponder = std::move(game->ai_ponder);
+        game->ai_ponder.reset();
+        // Threads still holding the game free it when they let go
         active_games.erase(it);
         
         std::cout << "[MatchManager] Cleaned up game: " << game_id << std::endl;
     }
     
     pthread_mutex_unlock(&mutex);
+    
+    // Outside the lock: the ponder may take a few nodes to unwind
+    if (ponder) {
+        stop_ponder(*ponder);
+    }
 }
 
 // ============================================================================
@@ -6,9 +6,13 @@
 #include <vector>
 #include <pthread.h>
 #include <ctime>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include "chess_game.cpp"
+#include "../ai/transposition_table.h"
+#include "../ai/chess_ai.h"
 
 using json = nlohmann::json;
 
@@ -24,42 +28,85 @@ struct Challenge {
     bool is_active;
 };
 
-// Active game instance
+// AI search run on the human's time: the position after the reply the AI
+// expects, searched while the human is still thinking
+struct AIPonder {
+    uint64_t position_key;    // position searched (after the expected reply)
+    std::atomic<bool> stop;   // ponder miss or game over: abandon the search
+    pthread_mutex_t mutex;    // guards the fields below
+    pthread_cond_t finished_cond;
+    bool started;             // a worker picked the search up
+    bool finished;
+    ChessAIMoveResult result;
+
+    explicit AIPonder(uint64_t key) : position_key(key), stop(false), started(false), finished(false), result() {
+        pthread_mutex_init(&mutex, nullptr);
+        pthread_cond_init(&finished_cond, nullptr);
+    }
+    ~AIPonder() {
+        pthread_cond_destroy(&finished_cond);
+        pthread_mutex_destroy(&mutex);
+    }
+};
+
+// Active game instance. Shared, so a connection or AI worker thread that
+// looked a game up keeps it alive even if the game ends meanwhile.
 struct GameInstance {
     int game_id;
     int white_player_id;
     int black_player_id;
     std::string white_username;
     std::string black_username;
-    ChessGame* chess_engine;
-    std::vector<std::string> move_history;
+    std::unique_ptr<ChessGame> chess_engine;
+    std::vector<Move> move_history;
     time_t start_time;
     bool is_active;
     bool white_draw_offered;
     bool black_draw_offered;
-    int ai_depth;  // Only used when one player is AI (-1)
+    std::string ai_difficulty;  // Only used when one player is AI (-1); see ChessAI::find_difficulty
+    int ai_depth;  // depth limit, the profile's unless the player overrode it
+    std::shared_ptr<TranspositionTable> ai_tt;  // AI games only; kept across the AI's moves
+    int ai_threads;  // search thread budget for the AI, if the server has spare cores
+    std::shared_ptr<AIPonder> ai_ponder;  // AI games only; while the human is to move
     int ai_think_ms;
     long long ai_nodes_searched;
 };
 
+// Outcome of one AI turn (see MatchManager::play_ai_turn)
+struct AITurnResult {
+    bool committed = false;   // move was played on the game
+    bool stale = false;       // game ended or changed while the AI was thinking; nothing played
+    bool timed_out = false;
+    bool game_ended = false;  // the position after the turn is terminal
+    GameResult result = ONGOING;
+    GameEndReason end_reason = END_NONE;
+    int human_player_id = 0;
+    bool ai_is_white = false;
+    json opponent_move;       // OPPONENT_MOVE payload, set when committed
+};
+
 // Callback for broadcasting messages
 using BroadcastCallback = std::function<void(int user_id, const json& message)>;
 
 class MatchManager {
 private:
     static constexpr int AI_USER_ID = -1;
+    static constexpr int AI_SMP_MIN_DEPTH = 5;  // shallower AI games search single-threaded
 
     // Active challenges and games
     static std::map<std::string, Challenge*> active_challenges;     // challenge_id -> Challenge
     static std::map<int, std::string> challenges_by_challenger;     // user_id -> challenge_id
     static std::map<int, std::string> challenges_by_target;         // user_id -> challenge_id
     
-    static std::map<int, GameInstance*> active_games;               // game_id -> GameInstance
+    static std::map<int, std::shared_ptr<GameInstance>> active_games;  // game_id -> GameInstance
     static std::map<int, int> player_to_game;                       // user_id -> game_id
     
     static pthread_mutex_t mutex;
     static BroadcastCallback broadcast_callback;
     static MatchManager* instance;
+    static size_t ai_hash_mb;  // transposition table budget per AI game
+    static int ai_threads_per_game;  // search thread budget per AI game of AI_SMP_MIN_DEPTH or more
+    static bool ai_ponder_enabled;
     
     // Generate unique challenge ID
     std::string generate_challenge_id();
@@ -67,6 +114,24 @@ private:
     // Helper to broadcast to a user
     void broadcast_to_user(int user_id, const json& message);
     
+    // Search and play the AI's move. The search runs on a snapshot without
+    // holding the mutex; the move is committed only if the game is unchanged.
+    AITurnResult play_ai_turn(int game_id);
+    
+    // AI worker job: play the AI's turn and push the result to the human
+    void run_ai_turn(int game_id, long long queue_wait_ms);
+    
+    // After the AI has moved, search the position after the human's expected
+    // reply on an idle worker. Skipped if no worker is idle.
+    void start_ponder(int game_id);
+    
+    // If the ponder searched position_key, wait for it to finish and take its
+    // move; otherwise stop it. Returns once the ponder no longer uses the
+    // game's table.
+    static bool finish_ponder(AIPonder& ponder, uint64_t position_key, ChessAIMoveResult& out);
+    // Stop the ponder and wait until it no longer uses the game's table
+    static void stop_ponder(AIPonder& ponder);
+    
     MatchManager();
     
 public:
@@ -78,6 +143,9 @@ public:
     // Initialize
     static void initialize();
     static void set_broadcast_callback(BroadcastCallback callback);
+    static void set_ai_hash_mb(size_t mb);
+    static void set_ai_threads_per_game(int threads);
+    static void set_ai_ponder(bool enabled);
     
     // Challenge management
     std::string create_challenge(int challenger_id, const std::string& challenger_username,
@@ -87,8 +155,8 @@ public:
     bool decline_challenge(const std::string& challenge_id);
     bool cancel_challenge(const std::string& challenge_id);
     bool accept_ai_challenge(int human_user_id, const std::string& human_username,
-                             const std::string& preferred_color, int ai_depth,
-                             int& out_game_id);
+                             const std::string& preferred_color, const std::string& ai_difficulty,
+                             int ai_depth, int& out_game_id);
     
     Challenge* get_challenge(const std::string& challenge_id);
     bool has_pending_challenge(int user_id);  // Either sent or received
@@ -97,14 +165,17 @@ public:
     // Game management
     int create_game(int white_player_id, const std::string& white_username,
                     int black_player_id, const std::string& black_username);
-    GameInstance* get_game(int game_id);
-    GameInstance* get_game_by_player(int user_id);
+    std::shared_ptr<GameInstance> get_game(int game_id);
+    std::shared_ptr<GameInstance> get_game_by_player(int user_id);
     int get_game_id_by_player(int user_id);
     bool is_player_in_game(int user_id);
     
     // Gameplay operations
-    bool make_move(int game_id, int player_id, const std::string& move, 
+    bool make_move(int game_id, int player_id, Move move, 
                    json& out_response, int& out_opponent_id);
+    // Queue the AI's reply if it is the AI's turn in this game; the move is
+    // delivered later as OPPONENT_MOVE through the broadcast callback
+    void request_ai_move(int game_id);
     bool resign_game(int game_id, int player_id, int& out_winner_id, int& out_loser_id);
     bool handle_player_disconnect(int user_id);
     bool offer_draw(int game_id, int player_id, int& out_opponent_id);
@@ -114,7 +185,7 @@ public:
     // Game state
     json get_game_state(int game_id);
     std::string get_board_fen(int game_id);
-    std::vector<std::string> get_move_history(int game_id);
+    std::vector<Move> get_move_history(int game_id);
     
     // End game
     void end_game(int game_id, const std::string& result, const std::string& reason);
@@ -0,0 +1,202 @@
+// Perft: counts the leaf nodes of the legal move tree to a fixed depth.
+// Used to verify the move generator against known node counts and to
+// benchmark make/unmake + generation speed.
+//
+// Usage:
+//   ./perft                                  run the built-in suite
+//   ./perft --suite [--max-nodes N]          same, skipping depths above N nodes
+//   ./perft --fen "<fen>" --depth N [--divide] [--threads T]
+//   ./perft --depth N                        start position
+
+#include "chess_game.cpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+struct SuitePosition {
+    const char* name;
+    const char* fen;
+    std::vector<long long> expected;  // expected[d - 1] = nodes at depth d
+};
+
+// Standard perft positions (chessprogramming.org "Perft Results")
+const std::vector<SuitePosition> SUITE = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+     {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603, 193690690}},
+    {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+     {14, 191, 2812, 43238, 674624, 11030083}},
+    {"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333, 15833292}},
+    {"position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+     {6, 264, 9467, 422333, 15833292}},
+    {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487, 89941194}},
+    {"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+     {46, 2079, 89890, 3894594, 164075551}},
+    // En passant squares from FEN; counts match playing the moves from the start
+    {"en passant 1.e4 d5 2.e5 f5", "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+     {31, 707, 21637, 524138, 16422290}},
+    {"en passant 1.a3 e5 2.a4 e4 3.d4", "rnbqkbnr/pppp1ppp/8/8/P2Pp3/8/1PP1PPPP/RNBQKBNR b KQkq d3 0 3",
+     {31, 839, 25956, 723699, 23086362}},
+};
+
+// FENs loadFEN must reject
+const std::vector<SuitePosition> INVALID = {
+    {"en passant square on the mover's side", "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e3 0 2", {}},
+    {"en passant without the pushed pawn", "rnbqkbnr/pppp1ppp/8/4P3/8/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2", {}},
+    {"en passant square occupied", "rnbqkb1r/pppp1ppp/4n3/3Pp3/8/8/PPP1PPPP/RNBQKBNR w KQkq e6 0 2", {}},
+};
+
+long long perft(ChessGame& game, int depth) {
+    MoveList moves;
+    game.generateLegalMoves(moves);
+    if (depth <= 1) return moves.size();
+
+    long long nodes = 0;
+    for (Move m : moves) {
+        game.makeMove(m);
+        nodes += perft(game, depth - 1);
+        game.unmakeMove();
+    }
+    return nodes;
+}
+
+// Splits the root moves across threads; each thread searches its own copy.
+long long perftRoot(const ChessGame& root, int depth, int threads, bool divide) {
+    MoveList moves;
+    root.generateLegalMoves(moves);
+    if (depth <= 1 && !divide) return moves.size();
+
+    std::vector<long long> counts(moves.size(), 0);
+    std::atomic<int> next_move(0);
+
+    auto worker = [&]() {
+        ChessGame game = root;
+        int i;
+        while ((i = next_move.fetch_add(1)) < moves.size()) {
+            game.makeMove(moves.moves[i]);
+            counts[i] = (depth <= 1) ? 1 : perft(game, depth - 1);
+            game.unmakeMove();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    long long total = 0;
+    for (int i = 0; i < moves.size(); i++) {
+        if (divide) std::cout << moves.moves[i].toString() << ": " << counts[i] << std::endl;
+        total += counts[i];
+    }
+    return total;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int runSuite(long long max_nodes, int threads) {
+    int failures = 0;
+    long long total_nodes = 0;
+    double total_seconds = 0;
+
+    std::cout << "=== Perft Suite ===" << std::endl;
+    for (const auto& entry : SUITE) {
+        ChessGame game;
+        if (!game.loadFEN(entry.fen)) {
+            std::cout << "✗ " << entry.name << ": could not load FEN" << std::endl;
+            failures++;
+            continue;
+        }
+
+        for (size_t d = 1; d <= entry.expected.size(); d++) {
+            long long expected = entry.expected[d - 1];
+            if (expected > max_nodes) break;
+
+            auto start = std::chrono::steady_clock::now();
+            long long nodes = perftRoot(game, static_cast<int>(d), threads, false);
+            double seconds = secondsSince(start);
+            total_nodes += nodes;
+            total_seconds += seconds;
+
+            bool ok = (nodes == expected);
+            if (!ok) failures++;
+            std::cout << (ok ? "✓ " : "✗ ") << entry.name << " depth " << d << ": " << nodes;
+            if (!ok) std::cout << " (expected " << expected << ")";
+            std::cout << std::endl;
+        }
+    }
+
+    for (const auto& entry : INVALID) {
+        ChessGame game;
+        bool ok = !game.loadFEN(entry.fen);
+        if (!ok) failures++;
+        std::cout << (ok ? "✓ rejects " : "✗ accepts ") << entry.name << std::endl;
+    }
+
+    std::cout << std::endl << "Nodes: " << total_nodes << " | Time: " << total_seconds << "s";
+    if (total_seconds > 0) std::cout << " | NPS: " << static_cast<long long>(total_nodes / total_seconds);
+    std::cout << std::endl;
+    std::cout << (failures == 0 ? "All perft counts match" : "Perft FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+void printUsage() {
+    std::cout << "Usage: perft [--suite] [--max-nodes N] [--fen \"<fen>\"] [--depth N] [--divide] [--threads T]"
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string fen;
+    int depth = 0;
+    int threads = 1;
+    bool divide = false;
+    bool suite = false;
+    long long max_nodes = 10000000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--fen" && has_value) fen = argv[++i];
+        else if (arg == "--depth" && has_value) depth = std::atoi(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::atoi(argv[++i]);
+        else if (arg == "--max-nodes" && has_value) max_nodes = std::atoll(argv[++i]);
+        else if (arg == "--divide") divide = true;
+        else if (arg == "--suite") suite = true;
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (threads < 1) threads = 1;
+
+    if (suite || depth <= 0) {
+        return runSuite(max_nodes, threads);
+    }
+
+    ChessGame game;
+    if (!fen.empty() && !game.loadFEN(fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 2;
+    }
+
+    std::cout << "FEN: " << game.getFEN() << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    long long nodes = perftRoot(game, depth, threads, divide);
+    double seconds = secondsSince(start);
+
+    std::cout << std::endl << "Depth " << depth << ": " << nodes << " nodes in " << seconds << "s";
+    if (seconds > 0) std::cout << " (" << static_cast<long long>(nodes / seconds) << " nps)";
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include <cstdint>
+
+// Piece-square tables for the tapered evaluation.
+//
+// Each entry is the piece's material plus a positional bonus for standing on
+// that square, once for the middlegame and once for the endgame. Tables are
+// written from white's side with a8 first, the way a board is printed; black
+// uses the vertically mirrored square and negated values, so summing entries
+// over the board gives a white-minus-black score.
+//
+// The game phase runs from PHASE_MAX (all minor and major pieces on the
+// board) down to 0 (kings and pawns only) and blends the two scores.
+
+constexpr int PHASE_MAX = 24;
+constexpr int phaseWeight[6] = {0, 4, 2, 1, 1, 0};  // indexed by PieceType
+
+constexpr int materialMg[6] = {0, 900, 500, 330, 320, 100};
+constexpr int materialEg[6] = {0, 900, 500, 330, 320, 120};
+
+// Indexed by PieceType (KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN)
+constexpr int16_t psqtMgSource[6][64] = {
+    {   // King: stay behind the pawn shield
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20,
+    },
+    {   // Queen
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20,
+    },
+    {   // Rook: seventh rank and central files
+          0,  0,  0,  0,  0,  0,  0,  0,
+          5, 10, 10, 10, 10, 10, 10,  5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+          0,  0,  0,  5,  5,  0,  0,  0,
+    },
+    {   // Bishop
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20,
+    },
+    {   // Knight: centralise
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50,
+    },
+    {   // Pawn: central pawns forward, keep the king's cover
+          0,  0,  0,  0,  0,  0,  0,  0,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         10, 10, 20, 30, 30, 20, 10, 10,
+          5,  5, 10, 25, 25, 10,  5,  5,
+          0,  0,  0, 20, 20,  0,  0,  0,
+          5, -5,-10,  0,  0,-10, -5,  5,
+          5, 10, 10,-20,-20, 10, 10,  5,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    },
+};
+
+constexpr int16_t psqtEgSource[6][64] = {
+    {   // King: centralise once the queens are off
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50,
+    },
+    {   // Queen
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20,
+    },
+    {   // Rook
+          0,  0,  0,  0,  0,  0,  0,  0,
+         10, 10, 10, 10, 10, 10, 10, 10,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    },
+    {   // Bishop
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5, 10, 10, 10, 10,  5,-10,
+        -10,  5, 10, 10, 10, 10,  5,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20,
+    },
+    {   // Knight
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50,
+    },
+    {   // Pawn: the further advanced, the closer to promoting
+          0,  0,  0,  0,  0,  0,  0,  0,
+         80, 80, 80, 80, 80, 80, 80, 80,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         30, 30, 30, 30, 30, 30, 30, 30,
+         15, 15, 15, 15, 15, 15, 15, 15,
+          5,  5,  5,  5,  5,  5,  5,  5,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    },
+};
+
+struct PieceSquareTables {
+    int32_t mg[2][6][64];  // [Color][PieceType][square], white-minus-black
+    int32_t eg[2][6][64];
+};
+
+constexpr PieceSquareTables makePieceSquareTables() {
+    PieceSquareTables t{};
+    for (int piece = 0; piece < 6; piece++) {
+        for (int sq = 0; sq < 64; sq++) {
+            // Source tables list a8 first; squares count from a1
+            int whiteIndex = sq ^ 56;
+            int blackIndex = sq;
+            t.mg[0][piece][sq] = materialMg[piece] + psqtMgSource[piece][whiteIndex];
+            t.eg[0][piece][sq] = materialEg[piece] + psqtEgSource[piece][whiteIndex];
+            t.mg[1][piece][sq] = -(materialMg[piece] + psqtMgSource[piece][blackIndex]);
+            t.eg[1][piece][sq] = -(materialEg[piece] + psqtEgSource[piece][blackIndex]);
+        }
+    }
+    return t;
+}
+
+inline constexpr PieceSquareTables psqt = makePieceSquareTables();
+
+#endif // PSQT_H
@@ -0,0 +1,61 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Zobrist hashing keys. A position's hash is the XOR of one key per
+// (color, piece, square) on the board, one per castling-rights mask, one for
+// the en passant file (when capturable) and one for black to move.
+//
+// The keys are generated at compile time from a fixed seed, so hashes are
+// stable across processes and builds. Anything persisted or shared between
+// processes (opening book, caches) relies on that.
+
+struct ZobristKeys {
+    uint64_t piece[2][6][64];  // [Color][PieceType][square]
+    uint64_t castling[16];     // indexed by the CastlingRight bit mask
+    uint64_t ep_file[8];
+    uint64_t black_to_move;
+};
+
+constexpr uint64_t zobristNext(uint64_t& state) {
+    // splitmix64
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    uint64_t state = 0x5A0B2157C8E6D3F1ULL;
+
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) {
+            for (int sq = 0; sq < 64; sq++) {
+                keys.piece[color][piece][sq] = zobristNext(state);
+            }
+        }
+    }
+
+    // Castling keys are built from four independent rights so that clearing
+    // one right always changes the hash by the same amount.
+    uint64_t rights[4] = {zobristNext(state), zobristNext(state), zobristNext(state), zobristNext(state)};
+    for (int mask = 0; mask < 16; mask++) {
+        keys.castling[mask] = 0;
+        for (int bit = 0; bit < 4; bit++) {
+            if (mask & (1 << bit)) keys.castling[mask] ^= rights[bit];
+        }
+    }
+
+    for (int file = 0; file < 8; file++) {
+        keys.ep_file[file] = zobristNext(state);
+    }
+    keys.black_to_move = zobristNext(state);
+    return keys;
+}
+
+inline constexpr ZobristKeys zobrist = makeZobristKeys();
+
+#endif // ZOBRIST_H
@@ -13,6 +13,10 @@
 
 #include "session/session_manager.h"
 #include "game/match_manager.h"
+#include "ai/ai_worker_pool.h"
+#include "ai/opening_book.h"
+#include "ai/endgame_bitbase.h"
+#include "ai/ai_result_cache.h"
 #include "network/websocket_handler.h"
 #include "network/socket_handler.h"
 #include "utils/message_handler.h"
@@ -114,6 +118,46 @@ int main() {
     
     cout << "[Server] MatchManager initialized with broadcast callback" << endl;
     
+    // AI worker pool; AI_WORKERS and AI_QUEUE_LIMIT override the defaults
+    // (one worker per core, 16 queued jobs per worker)
+    // AI_SEARCH_THREADS caps busy workers plus multi-threaded search helpers (default: cores)
+    const char* ai_workers_env = getenv("AI_WORKERS");
+    const char* ai_queue_env = getenv("AI_QUEUE_LIMIT");
+    const char* ai_search_threads_env = getenv("AI_SEARCH_THREADS");
+    AIWorkerPool::initialize(ai_workers_env ? atoi(ai_workers_env) : 0,
+                             ai_queue_env ? strtoul(ai_queue_env, nullptr, 10) : 0,
+                             ai_search_threads_env ? atoi(ai_search_threads_env) : 0);
+    
+    // Transposition table size per AI game (MB)
+    const char* ai_hash_env = getenv("AI_HASH_MB");
+    if (ai_hash_env) {
+        MatchManager::set_ai_hash_mb(strtoul(ai_hash_env, nullptr, 10));
+    }
+    
+    // Opening book shared by all AI searches (build it with `make book`)
+    const char* ai_book_env = getenv("AI_BOOK");
+    OpeningBook::initialize(ai_book_env ? ai_book_env : "config/opening_book.bin");
+    
+    // KQK/KRK/KPK endgame tables (build them with `make bitbases`)
+    const char* ai_bitbase_env = getenv("AI_BITBASE");
+    EndgameBitbase::initialize(ai_bitbase_env ? ai_bitbase_env : "config/endgame_bitbase.bin");
+    
+    // AI moves shared between games, by position and difficulty (entries)
+    const char* ai_cache_env = getenv("AI_RESULT_CACHE");
+    AIResultCache::initialize(ai_cache_env ? strtoul(ai_cache_env, nullptr, 10) : 0);
+    
+    // Search threads per hard AI game, taken from the spare AI_SEARCH_THREADS budget
+    const char* ai_threads_env = getenv("AI_THREADS_PER_GAME");
+    if (ai_threads_env) {
+        MatchManager::set_ai_threads_per_game(atoi(ai_threads_env));
+    }
+    
+    // Search the expected reply while the human thinks; AI_PONDER=0 turns it off
+    const char* ai_ponder_env = getenv("AI_PONDER");
+    if (ai_ponder_env) {
+        MatchManager::set_ai_ponder(atoi(ai_ponder_env) != 0);
+    }
+    
     int server_sock = socket(AF_INET, SOCK_STREAM, 0);
     
     if (server_sock < 0) {
@@ -188,8 +232,16 @@ int main() {
         
         pthread_detach(thread_id);
         
+        AIWorkerPool::Stats ai_stats = AIWorkerPool::get_instance()->get_stats();
+        AIResultCache::Stats cache_stats = AIResultCache::get_instance()->get_stats();
         cout << "[Server] Active sessions: " << SessionManager::get_instance()->get_active_session_count() 
-             << " | Active games: " << MatchManager::get_instance()->get_active_game_count() << endl;
+             << " | Active games: " << MatchManager::get_instance()->get_active_game_count()
+             << " | AI busy: " << ai_stats.busy_workers << "/" << ai_stats.workers
+             << " (+" << ai_stats.helper_threads << " helpers, budget " << ai_stats.max_search_threads << ")"
+             << " | AI queue: " << ai_stats.queue_depth
+             << " (avg wait " << ai_stats.avg_wait_ms << "ms, max " << ai_stats.max_wait_ms << "ms)"
+             << " | AI cache: " << cache_stats.hits << " hits / " << cache_stats.misses << " misses ("
+             << cache_stats.entries << "/" << cache_stats.capacity << " entries)" << endl;
     }
 
     close(server_sock);
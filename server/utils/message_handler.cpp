@@ -1,17 +1,10 @@
 #include "message_handler.h"
 #include "message_types.h"
 #include "../network/websocket_handler.h"
+#include "../ai/chess_ai.h"
 #include <iostream>
 #include <ctime>
 
-namespace {
-int depth_from_difficulty(const std::string& difficulty) {
-    if (difficulty == "easy") return 1;
-    if (difficulty == "hard") return 4;
-    return 2;
-}
-}
-
 MessageHandler::MessageHandler(int socket, std::string ip_address) : client_socket(socket), ip_address(ip_address) {
     session_mgr = SessionManager::get_instance();
     match_mgr = MatchManager::get_instance();
@@ -516,18 +509,20 @@ void MessageHandler::handle_ai_challenge(const json& request) {
         } catch (...) {
             difficulty = "medium";
         }
-        if (difficulty != "easy" && difficulty != "medium" && difficulty != "hard") {
-            send_error("INVALID_DIFFICULTY", "difficulty must be easy, medium, or hard");
-            return;
-        }
+    }
+    const AIDifficulty* profile = ChessAI::find_difficulty(difficulty);
+    if (!profile) {
+        send_error("INVALID_DIFFICULTY", "difficulty must be easy, medium, or hard");
+        return;
     }
 
-    int depth = depth_from_difficulty(difficulty);
+    // The profile's node and time budgets still apply to an explicit depth
+    int depth = profile->depth;
     if (request.contains("depth")) {
         try {
             depth = request["depth"].get<int>();
         } catch (...) {
-            depth = depth_from_difficulty(difficulty);
+            depth = profile->depth;
         }
     }
     if (depth < 1) depth = 1;
@@ -554,7 +549,7 @@ void MessageHandler::handle_ai_challenge(const json& request) {
 
     // Create a new game with AI opponent. Note: id of AI is fixed -1.
     int game_id = -1;
-    if (!match_mgr->accept_ai_challenge(session->user_id, session->username, preferred_color, depth, game_id)) {
+    if (!match_mgr->accept_ai_challenge(session->user_id, session->username, preferred_color, difficulty, depth, game_id)) {
         send_error("AI_CHALLENGE_FAILED", "Failed to create AI game");
         return;
     }
@@ -717,10 +712,11 @@ void MessageHandler::handle_move(const json& request) {
     }
     
     int game_id = request["game_id"].get<int>();
-    std::string move = request["move"].get<std::string>();
+    std::string move_str = request["move"].get<std::string>();
+    Move move = Move::fromString(move_str);
     
     // Verify player is in this game
-    GameInstance* game = match_mgr->get_game(game_id);
+    std::shared_ptr<GameInstance> game = match_mgr->get_game(game_id);
     if (!game) {
         send_error("GAME_NOT_FOUND", "Game not found");
         return;
@@ -734,42 +730,22 @@ void MessageHandler::handle_move(const json& request) {
     // Attempt move
     json response;
     int opponent_id;
-    if (match_mgr->make_move(game_id, session->user_id, move, response, opponent_id)) {
-        json ai_followup_move;
-        json ai_followup_error;
-        bool has_ai_followup_move = false;
-        bool has_ai_followup_error = false;
-
-        if (response.contains("ai_followup_move")) {
-            ai_followup_move = response["ai_followup_move"];
-            response.erase("ai_followup_move");
-            has_ai_followup_move = true;
-        }
-        if (response.contains("ai_followup_error")) {
-            ai_followup_error = response["ai_followup_error"];
-            response.erase("ai_followup_error");
-            has_ai_followup_error = true;
-        }
-
+    if (!move.isNull() && match_mgr->make_move(game_id, session->user_id, move, response, opponent_id)) {
         send_response(response);
 
-        // Preserve client ordering: acknowledge human move first, then push AI follow-up.
-        if (has_ai_followup_move) {
-            broadcast_to_user(session->user_id, ai_followup_move);
-        }
-        if (has_ai_followup_error) {
-            broadcast_to_user(session->user_id, ai_followup_error);
-        }
+        // Acknowledge the human move first; an AI reply is queued only now so
+        // its OPPONENT_MOVE cannot overtake MOVE_ACCEPTED.
+        match_mgr->request_ai_move(game_id);
 
-        std::cout << "[MessageHandler] Move executed: " << move << " in game " << game_id << std::endl;
+        std::cout << "[MessageHandler] Move executed: " << move_str << " in game " << game_id << std::endl;
     } else {
         json rejection;
         rejection["type"] = MessageTypes::MOVE_REJECTED;
         rejection["game_id"] = game_id;
-        rejection["move"] = move;
+        rejection["move"] = move_str;
         rejection["reason"] = "Illegal move";
         send_response(rejection);
-        std::cout << "[MessageHandler] Move rejected: " << move << " in game " << game_id << std::endl;
+        std::cout << "[MessageHandler] Move rejected: " << move_str << " in game " << game_id << std::endl;
     }
 }
 
@@ -790,7 +766,7 @@ void MessageHandler::handle_resign(const json& request) {
     int game_id = request["game_id"].get<int>();
     
     // Verify player is in this game
-    GameInstance* game = match_mgr->get_game(game_id);
+    std::shared_ptr<GameInstance> game = match_mgr->get_game(game_id);
     if (!game) {
         send_error("GAME_NOT_FOUND", "Game not found");
         return;
@@ -834,7 +810,7 @@ void MessageHandler::handle_draw_offer(const json& request) {
     int game_id = request["game_id"].get<int>();
     
     // Verify player is in this game
-    GameInstance* game = match_mgr->get_game(game_id);
+    std::shared_ptr<GameInstance> game = match_mgr->get_game(game_id);
     if (!game) {
         send_error("GAME_NOT_FOUND", "Game not found");
         return;
@@ -879,7 +855,7 @@ void MessageHandler::handle_draw_response(const json& request) {
     bool accepted = request["accepted"].get<bool>();
     
     // Verify player is in this game
-    GameInstance* game = match_mgr->get_game(game_id);
+    std::shared_ptr<GameInstance> game = match_mgr->get_game(game_id);
     if (!game) {
         send_error("GAME_NOT_FOUND", "Game not found");
         return;
@@ -1013,7 +989,7 @@ void MessageHandler::handle_get_game_state(const json& request) {
     }
     
     // Verify player is in this game
-    GameInstance* game = match_mgr->get_game(game_id);
+    std::shared_ptr<GameInstance> game = match_mgr->get_game(game_id);
     if (game && game->white_player_id != session->user_id && game->black_player_id != session->user_id) {
         send_error("NOT_IN_GAME", "You are not a player in this game");
         return;